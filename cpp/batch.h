@@ -0,0 +1,107 @@
+#pragma once
+
+#include "code.h"
+#include "pool.h"
+
+/** \defgroup Batch Run many independent queries on the same grid, concurrently.
+
+    Queries are run on a work_stealing_pool, sharing the read-only neighborhood and transit operators.
+    Each worker allocates its costs and front once, and reuses them for all the queries it runs.
+
+  @{
+*/
+
+//! A single-seed query.
+struct query_t
+{
+    point_t seed;
+    unsigned int iterations;
+};
+
+/** The buffers used by a worker to run a query. */
+template<typename Front = front_t>
+struct scratch_t
+{
+    scratch_t(const grid_t & grid) : costs(grid), front(grid) {}
+
+    void reset()
+    {
+        costs.reset();
+        front.clear();
+    }
+
+    costs_t costs;
+    Front front;
+};
+
+/** Run a query, propagating with the given neighborhood and transit functions, without printing progress.
+
+    This is the run to be given to batch_run for the compositions calling algo_run
+    (functional, strategy and CRTP). */
+template<typename Front = front_t>
+std::function< void(scratch_t<Front> &, const query_t &) > batch_propagation(
+        std::function< neighbors_t(const point_t&) > neighbors,
+        std::function< double(const point_t &, const neighbors_t &, const costs_t &) > transit
+    )
+{
+    return [neighbors,transit] (scratch_t<Front> & scratch, const query_t & query) mutable
+    {
+        const grid_t & grid = scratch.costs.grid();
+        scratch.costs[query.seed] = 0;
+        scratch.front.push(grid.index(query.seed), 0);
+        algo_propagate(scratch.costs, nullptr, scratch.front, query.iterations, neighbors, transit, nullptr);
+    };
+}
+
+/** Run all the given queries on the pool.
+
+  \param run Fills the (reset) scratch with the costs computed for the given query.
+             It is called concurrently and should thus be thread-safe.
+  \param on_result Called by the workers as soon as a query is done, with its rank and its costs.
+                   The costs are those of the worker's scratch, and are thus only valid during the call.
+                   It is called concurrently and should thus be thread-safe.
+ */
+template<typename Front = front_t>
+void batch_run(
+        const grid_t & grid,
+        const std::vector<query_t> & queries,
+        work_stealing_pool & pool,
+        std::function< void(scratch_t<Front> &, const query_t &) > run,
+        std::function< void(size_t, const costs_t &) > on_result
+    )
+{
+    // Scratches are allocated by their worker, at its first query.
+    std::vector< std::unique_ptr< scratch_t<Front> > > scratches(pool.size());
+
+    for( size_t q = 0; q < queries.size(); ++q ) {
+        pool.submit( [&,q] (unsigned int worker) {
+            if( not scratches[worker] ) {
+                scratches[worker].reset( new scratch_t<Front>(grid) );
+            } else {
+                scratches[worker]->reset();
+            }
+            run(*scratches[worker], queries[q]);
+            on_result(q, scratches[worker]->costs);
+        });
+    }
+    pool.wait();
+}
+
+/** Run all the given queries on the pool, and return all their costs, in the order of the queries. */
+template<typename Front = front_t>
+std::vector<costs_t> batch_run(
+        const grid_t & grid,
+        const std::vector<query_t> & queries,
+        work_stealing_pool & pool,
+        std::function< void(scratch_t<Front> &, const query_t &) > run
+    )
+{
+    std::vector<costs_t> results(queries.size(), costs_t(grid));
+    batch_run<Front>(grid, queries, pool, run, [&results] (size_t q, const costs_t & costs) {
+        // Each query has its own slot, no need to lock.
+        results[q] = costs;
+    });
+    return results;
+}
+
+/** @} Batch */
@@ -0,0 +1,117 @@
+/** Trade the accuracy of the compositions against their throughput.
+
+    On an unobstructed square domain, the exact cost from the seed (at the center)
+    is the euclidean distance to it. Each composition (4 or 8 neighbors, on edges,
+    in simplexes at several eps, or exact in simplexes) is run on the whole grid,
+    at several grid steps over the same domain.
+    For each run, the mean (L1) and max (L∞) absolute errors against the distance,
+    the best time out of the given repetitions and the accepted nodes per second are printed (in TSV),
+    sorted by increasing L∞ error.
+
+    The last columns flag the Pareto optimal runs: no other run is both faster
+    and (at least as) accurate, in L1 or in L∞. The cheapest run meeting a tolerance
+    is thus the fastest Pareto optimal one whose error is below it.
+
+    Usage: bench_accuracy [extent=128] [repetitions=3]
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#include "code.h"
+#include "timing.h"
+
+struct accuracy_t
+{
+    std::string neighbors;
+    std::string transit;
+    double eps;
+    double step;
+    size_t nodes;
+    double l1;
+    double linf;
+    double ms;
+    bool pareto_l1;
+    bool pareto_linf;
+};
+
+//! True if the run b is at least as good as a on both the error and the time, and better on one of them.
+bool dominates(double error_b, double ms_b, double error_a, double ms_a)
+{
+    return error_b <= error_a and ms_b <= ms_a and (error_b < error_a or ms_b < ms_a);
+}
+
+int main(int argc, char** argv)
+{
+    double extent = argc > 1 ? std::stod(argv[1]) : 128;
+    unsigned int repetitions = argc > 2 ? std::stoi(argv[2]) : 3;
+
+    using transit_f = std::function< double(const point_t &, const neighbors_t &, const costs_t &) >;
+    struct transit_case_t {std::string name; double eps; transit_f transit;};
+    std::vector<transit_case_t> transits{
+        {"on_edge", 0, transit_on_edge},
+        {"in_simplex_exact", 0, transit_in_simplex_exact}
+    };
+    for( double eps : {0.5, 0.2, 0.1, 0.05, 0.01} ) {
+        transits.push_back({"in_simplex", eps,
+            [eps](const point_t & p, const neighbors_t & n, const costs_t & c) {return transit_in_simplex(p,n,c,eps);}});
+    }
+
+    std::vector<accuracy_t> runs;
+    for( double step : {1.0, 0.5, 0.25} ) {
+        grid_t grid(make_point(-extent/2,-extent/2), make_point(extent/2,extent/2), step);
+        point_t seed = grid.point(static_cast<long>(grid.width/2), static_cast<long>(grid.height/2));
+        auto four  = [&grid](const point_t& p) {return neighbors_grid<quad_stencil>(p,grid);};
+        auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+        std::vector< std::pair< std::string, std::function< neighbors_t(const point_t&) > > > neighborhoods{
+            {"4", four}, {"8", eight}
+        };
+
+        for( auto & n : neighborhoods ) {
+            for( auto & t : transits ) {
+                costs_t costs(grid);
+                double ms = std::numeric_limits<double>::infinity();
+                for( unsigned int r = 0; r < std::max(1u, repetitions); ++r ) {
+                    costs = costs_t(grid);
+                    front_t front(grid);
+                    ms = std::min(ms, chrono_ms([&](){
+                        costs[seed] = 0;
+                        front.push(grid.index(seed), 0);
+                        algo_propagate(costs, nullptr, front, grid.size(), n.second, t.transit, nullptr);
+                    }));
+                }
+
+                accuracy_t run{n.first, t.name, t.eps, step, grid.width * grid.height, 0, 0, ms, true, true};
+                for( long j = 0; j < static_cast<long>(grid.height); ++j ) {
+                    for( long i = 0; i < static_cast<long>(grid.width); ++i ) {
+                        point_t p = grid.point(i,j);
+                        double error = std::abs(costs.at(grid.index(i,j)) - distance(p, seed));
+                        run.l1 += error;
+                        run.linf = std::max(run.linf, error);
+                    }
+                }
+                run.l1 /= static_cast<double>(run.nodes);
+                runs.push_back(run);
+            }
+        }
+    }
+
+    for( auto & a : runs ) {
+        for( auto & b : runs ) {
+            a.pareto_l1   &= not dominates(b.l1,   b.ms, a.l1,   a.ms);
+            a.pareto_linf &= not dominates(b.linf, b.ms, a.linf, a.ms);
+        }
+    }
+    std::sort(runs.begin(), runs.end(), [](const accuracy_t & a, const accuracy_t & b) {return a.linf < b.linf;});
+
+    std::ostream & log = std::cout;
+    log << "neighbors\ttransit\teps\tstep\tnodes\tl1_error\tlinf_error\tms\tnodes_per_s\tpareto_l1\tpareto_linf" << std::endl;
+    for( auto & r : runs ) {
+        log << r.neighbors << "\t" << r.transit << "\t" << r.eps << "\t" << r.step << "\t" << r.nodes
+            << "\t" << r.l1 << "\t" << r.linf << "\t" << r.ms << "\t" << r.nodes / r.ms * 1e3
+            << "\t" << r.pareto_l1 << "\t" << r.pareto_linf << std::endl;
+    }
+}
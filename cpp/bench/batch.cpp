@@ -0,0 +1,54 @@
+/** Throughput of batched queries against successive calls to algo_run.
+
+    Many single-seed 8-neighbors Dijkstra queries, with random seeds, are run on a small grid,
+    first one after the other with algo_run, then with batch_run on pools of growing sizes.
+    The numbers of queries per second are printed.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <queue>
+#include <cassert>
+#include <functional>
+#include <random>
+
+#include "code.h"
+#include "batch.h"
+#include "timing.h"
+
+int main(int argc, char** argv)
+{
+    unsigned int side = argc > 1 ? std::stoi(argv[1]) : 64;
+    size_t nb_queries = argc > 2 ? std::stoi(argv[2]) : 1000;
+    unsigned int max_workers = argc > 3 ? std::stoi(argv[3]) : std::max(1U, std::thread::hardware_concurrency());
+
+    grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<long> coord(0, side-1);
+    std::vector<query_t> queries;
+    for( size_t q = 0; q < nb_queries; ++q ) {
+        queries.push_back( {grid.point(coord(rng), coord(rng)), static_cast<unsigned int>(grid.size())} );
+    }
+
+    std::cout << "runner\tworkers\tqueries_per_s" << std::endl;
+
+    double sequential_s = chrono_s([&](){
+        for( const query_t & q : queries ) {
+            algo_run(grid, q.seed, q.iterations, eight, transit_on_edge, nullptr, nullptr);
+        }
+    });
+    std::cout << "algo_run\t1\t" << nb_queries / sequential_s << std::endl;
+
+    for( unsigned int workers = 1; workers <= max_workers; workers *= 2 ) {
+        work_stealing_pool pool(workers);
+        double batch_s = chrono_s([&](){
+            batch_run(grid, queries, pool, batch_propagation(eight, transit_on_edge), [](size_t, const costs_t &) {});
+        });
+        std::cout << "batch_run\t" << workers << "\t" << nb_queries / batch_s << std::endl;
+    }
+}
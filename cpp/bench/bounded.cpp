@@ -0,0 +1,71 @@
+/** Compare the dense propagation with the one bounded by the width of the front.
+
+    On side×side grids, the exact fast marching is run from a corner and from the center,
+    keeping all the costs, or evicting the blocks of final costs to a sink which only sums them.
+    The time, the time per node and the peak memory held by the costs and the front are printed (in TSV).
+
+    Usage: bench_bounded [max_side=2048] [block_log2=6]
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#include "code.h"
+#include "bounded.h"
+#include "timing.h"
+
+int main(int argc, char** argv)
+{
+    unsigned int max_side = argc > 1 ? std::stoi(argv[1]) : 2048;
+    unsigned int block_log2 = argc > 2 ? std::stoi(argv[2]) : 6;
+
+    std::cout << "seed\tside\tmode\tms\tns_per_node\tpeak_MiB\tpeak_blocks\tsum" << std::endl;
+    for( unsigned int side = 512; side <= max_side; side *= 2 ) {
+        grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+        auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+        double nodes = static_cast<double>(grid.size());
+
+        std::vector< std::pair<std::string,point_t> > seeds{{"corner", grid.point(0,0)}, {"center", grid.point(side/2,side/2)}};
+        for( auto & s : seeds ) {
+            double dense_sum = 0;
+            size_t dense_bytes = 0;
+            double dense_ms = chrono_ms([&](){
+                costs_t costs(grid);
+                front_t front(grid);
+                costs[s.second] = 0;
+                front.push(grid.index(s.second), 0);
+                size_t peak_front = 0;
+                // Without progress output.
+                while( not front.empty() ) {
+                    algo_propagate(costs, nullptr, front, side, eight, transit_in_simplex_exact, nullptr);
+                    peak_front = std::max(peak_front, front.size());
+                }
+                for( size_t i = 0; i < costs.size(); ++i ) {
+                    dense_sum += costs.at(i);
+                }
+                // The costs, the positions in the front, and the heap.
+                dense_bytes = costs.size() * (sizeof(double) + sizeof(size_t)) + peak_front * (sizeof(double) + sizeof(size_t));
+            });
+            std::cout << s.first << "\t" << side << "\tdense\t" << dense_ms << "\t" << dense_ms * 1e6 / nodes
+                << "\t" << dense_bytes / (1024.0*1024.0) << "\t" << "NA" << "\t" << dense_sum << std::endl;
+
+            double bounded_sum = 0;
+            auto sum = [&bounded_sum](const costs_tile<double> & tile) {
+                for( size_t dj = 0; dj < tile.height; ++dj ) {
+                    for( size_t di = 0; di < tile.width; ++di ) {
+                        bounded_sum += tile.at(di, dj);
+                    }
+                }
+            };
+            bounded_stats_t stats;
+            double bounded_ms = chrono_ms([&](){
+                stats = bounded_run<double>(grid, s.second, eight, transit_in_simplex_exact_of<double,paged_costs>, sum, block_log2);
+            });
+            std::cout << s.first << "\t" << side << "\tbounded\t" << bounded_ms << "\t" << bounded_ms * 1e6 / nodes
+                << "\t" << stats.peak_bytes / (1024.0*1024.0) << "\t" << stats.peak_blocks << "\t" << bounded_sum << std::endl;
+        }
+    }
+}
@@ -0,0 +1,80 @@
+/** Scaling of the heap front against the bucketed front, on growing grids.
+
+    Both fronts run an 8-neighbors Dijkstra and an exact 8-neighbors fast marching
+    over the whole grid. The time per accepted node is printed, with its growth since
+    the smallest side and the speedup of the buckets over the heap, along with the
+    largest difference between the costs computed with the buckets and with the heap.
+
+    The sides double from 64 up to the given maximum, then go on to 10240,
+    so that the heap's log n grows visibly: `bench_bucket 10240`.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <queue>
+#include <cassert>
+#include <functional>
+
+#include "code.h"
+#include "timing.h"
+
+int main(int argc, char** argv)
+{
+    unsigned int max_side = argc > 1 ? std::stoi(argv[1]) : 2048;
+    const size_t min_nodes = 1 << 22;
+
+    using transit_f = std::function< double(const point_t &, const neighbors_t &, const costs_t &) >;
+    std::vector< std::pair<std::string,transit_f> > transits{
+        {"dijkstra", transit_on_edge},
+        {"fast_marching", transit_in_simplex_exact}
+    };
+
+    std::vector<unsigned int> sides;
+    for( unsigned int side = 64; side <= max_side; side *= 2) {
+        sides.push_back(side);
+    }
+    if( max_side >= 10240 ) {
+        sides.push_back(10240);
+    }
+
+    std::cout << "transit\tside\tcells\theap_ns_per_node\tbucket_ns_per_node\theap_growth\tbucket_growth\tspeedup\tmax_diff" << std::endl;
+    for( auto & t : transits ) {
+        double heap_first = 0, bucket_first = 0;
+        for( unsigned int side : sides ) {
+            grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+            point_t seed = grid.point(side/2, side/2);
+            auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+
+            costs_t heap(grid), bucket(grid);
+            // Repeat the small grids, so that each timing covers enough nodes to be stable.
+            size_t runs = std::max<size_t>(1, min_nodes / grid.size());
+            double heap_ns = chrono_ns([&](){
+                for( size_t r = 0; r < runs; ++r ) {
+                    heap = algo_run<front_t>(grid, seed, grid.size(), eight, t.second, nullptr, nullptr);
+                }
+            });
+            double bucket_ns = chrono_ns([&](){
+                for( size_t r = 0; r < runs; ++r ) {
+                    bucket = algo_run<bucket_front<std::ratio<1>>>(grid, seed, grid.size(), eight, t.second, nullptr, nullptr);
+                }
+            });
+
+            double max_diff = 0;
+            for( size_t idx = 0; idx < grid.size(); ++idx ) {
+                max_diff = std::max(max_diff, std::abs(heap.at(idx) - bucket.at(idx)));
+            }
+            double heap_per_node = heap_ns / (runs * grid.size()), bucket_per_node = bucket_ns / (runs * grid.size());
+            if( side == sides.front() ) {
+                heap_first = heap_per_node;
+                bucket_first = bucket_per_node;
+            }
+            std::cout << t.first << "\t" << side << "\t" << grid.size()
+                << "\t" << heap_per_node << "\t" << bucket_per_node
+                << "\t" << heap_per_node / heap_first << "\t" << bucket_per_node / bucket_first
+                << "\t" << heap_per_node / bucket_per_node << "\t" << max_diff << std::endl;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/** Queries served by the cache of costs fields, against propagations from each seed.
+
+    On a side×side grid, queries from random seeds ask for the cost of a fixed point,
+    with the 8-neighbors exact fast marching:
+    - propagate: the costs are computed for each query,
+    - uniform: the views on the canonical field,
+    - lru: the least recently used cache, with seeds drawn among twice as many points as its capacity.
+    The time, the queries per second and the hit rate are printed (in TSV).
+
+    Usage: bench_cache [side=256] [queries=200] [capacity=16]
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <random>
+#include <cmath>
+
+#include "code.h"
+#include "cache.h"
+#include "timing.h"
+
+int main(int argc, char** argv)
+{
+    unsigned int side = argc > 1 ? std::stoi(argv[1]) : 256;
+    unsigned int queries = argc > 2 ? std::stoi(argv[2]) : 200;
+    unsigned int capacity = argc > 3 ? std::stoi(argv[3]) : 16;
+
+    grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+    const point_t target = grid.point(side/3, side/5);
+    const cache_key_t key{"octo", "in_simplex_exact", 0};
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<long> coord(0, side-1);
+    std::vector<point_t> seeds;
+    for( unsigned int q = 0; q < queries; ++q ) {
+        seeds.push_back(grid.point(coord(rng), coord(rng)));
+    }
+    std::vector<point_t> pool(seeds.begin(), seeds.begin() + std::min<size_t>(2 * capacity, seeds.size()));
+    std::uniform_int_distribution<size_t> pick(0, pool.size()-1);
+    std::vector<point_t> repeated;
+    for( unsigned int q = 0; q < queries; ++q ) {
+        repeated.push_back(pool[pick(rng)]);
+    }
+
+    std::cout << "mode\tside\tqueries\tms\tqueries_per_s\thit_rate\tsum" << std::endl;
+    auto print = [&] (const std::string & mode, double ms, double hit_rate, double sum) {
+        std::cout << mode << "\t" << side << "\t" << queries << "\t" << ms << "\t" << queries * 1e3 / ms << "\t" << hit_rate << "\t" << sum << std::endl;
+    };
+
+    double sum = 0;
+    double ms = chrono_ms([&](){
+        for( const point_t & seed : seeds ) {
+            sum += algo_run(grid, seed, grid.size(), eight, transit_in_simplex_exact, nullptr, nullptr).at(target);
+        }
+    });
+    print("propagate", ms, 0, sum);
+
+    costs_cache uniform(capacity);
+    sum = 0;
+    ms = chrono_ms([&](){
+        for( const point_t & seed : seeds ) {
+            sum += uniform.uniform<octo_stencil>(key, grid, seed, transit_in_simplex_exact).at(target);
+        }
+    });
+    print("uniform", ms, uniform.stats().hit_rate(), sum);
+
+    costs_cache lru(capacity);
+    sum = 0;
+    ms = chrono_ms([&](){
+        for( const point_t & seed : repeated ) {
+            sum += lru.any(key, grid, seed, grid.size(), eight, transit_in_simplex_exact).at(target);
+        }
+    });
+    print("lru", ms, lru.stats().hit_rate(), sum);
+
+}
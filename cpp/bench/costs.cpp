@@ -0,0 +1,86 @@
+/** Compare the dense costs grid against the former sparse std::map storage.
+
+    Both variants run the same 8-neighbors Dijkstra over the whole grid,
+    for growing grid sizes, and the elapsed times are printed as a table.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <map>
+#include <queue>
+#include <cassert>
+#include <functional>
+
+#include "code.h"
+#include "timing.h"
+
+/** \defgroup Map The former costs storage, kept as a baseline.
+  @{
+ */
+using map_costs_t = std::map<point_t,double>;
+using map_front_t = std::priority_queue<point_t,std::vector<point_t>,std::function< bool(const point_t, const point_t) >>;
+
+bool has_cost(point_t p, const map_costs_t & costs)
+{
+    return costs.find(p) != costs.end() and costs.at(p) < std::numeric_limits<double>::infinity();
+}
+
+double map_transit_on_edge(const point_t & p, const neighbors_t & neighbors, const map_costs_t & costs)
+{
+    double mincost = std::numeric_limits<double>::infinity();
+    for( auto n : neighbors ) {
+        if( has_cost(n, costs) ) {
+            double c = costs.at(n) + distance(p, n);
+            if( c < mincost ) {
+                mincost = c;
+            }
+        }
+    }
+    assert(mincost != std::numeric_limits<double>::infinity());
+    return mincost;
+}
+
+map_costs_t map_algo_run(point_t seed, unsigned int iterations, std::function< neighbors_t(const point_t&) > neighbors, std::ostream * progress = &std::cout)
+{
+    map_costs_t costs;
+    auto compare = [&costs](const point_t& lhs, const point_t& rhs) { return costs[lhs] > costs[rhs]; };
+    map_front_t front(compare);
+    costs[seed] = 0;
+    front.push(seed);
+    unsigned int i=0;
+    while(i++ < iterations and not front.empty()) {
+        if( progress ) {
+            *progress << "\r" << i << "/" << iterations;
+        }
+        point_t accepted = front.top(); front.pop();
+        neighbors_t around = neighbors(accepted);
+        for( auto n : around ) {
+            if( not has_cost(n, costs)) {
+                costs[n] = map_transit_on_edge(n, neighbors(n), costs);
+                front.push(n);
+            }
+        }
+    }
+    return costs;
+}
+/** @} Map */
+
+int main(int argc, char** argv)
+{
+    unsigned int max_side = argc > 1 ? std::stoi(argv[1]) : 512;
+
+    std::cout << "side\tcells\tmap_ms\tdense_ms\tspeedup" << std::endl;
+    for( unsigned int side = 32; side <= max_side; side *= 2) {
+        grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+        point_t seed = grid.point(side/2, side/2);
+        auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+
+        double map_ms = chrono_ms([&](){ map_algo_run(seed, grid.size(), eight, nullptr); });
+        double dense_ms = chrono_ms([&](){ algo_run(grid, seed, grid.size(), eight, transit_on_edge, nullptr, nullptr); });
+
+        std::cout << side << "\t" << grid.size() << "\t" << map_ms << "\t" << dense_ms << "\t" << map_ms / dense_ms << std::endl;
+    }
+}
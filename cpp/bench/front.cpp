@@ -0,0 +1,99 @@
+/** Throughput of the indexed heap front against the former priority queue.
+
+    The former front was a std::priority_queue of points,
+    ordered by a std::function comparator looking up costs in a std::map.
+    As it cannot decrease a key, its updates are emulated by changing all the costs,
+    then rebuilding the queue.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <map>
+#include <queue>
+#include <cassert>
+#include <functional>
+#include <random>
+
+#include "code.h"
+#include "timing.h"
+
+using map_costs_t = std::map<point_t,double>;
+using map_front_t = std::priority_queue<point_t,std::vector<point_t>,std::function< bool(const point_t, const point_t) >>;
+
+//! Millions of operations per second.
+template<typename F>
+double chrono_mops(size_t ops, F f)
+{
+    return ops / chrono_in<std::micro>(f);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int side = argc > 1 ? std::stoi(argv[1]) : 512;
+    grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+    const size_t n = grid.size();
+
+    // Random costs, and random decreased costs for the updates.
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> uniform(0,1);
+    std::vector<double> first(n), second(n);
+    for( size_t i=0; i<n; ++i) {
+        first[i] = uniform(rng);
+        second[i] = first[i] * uniform(rng);
+    }
+
+    std::cout << "front\tpush_Mops\tupdate_Mops\tpop_Mops" << std::endl;
+
+    {
+        map_costs_t costs;
+        auto compare = [&costs](const point_t& lhs, const point_t& rhs) { return costs[lhs] > costs[rhs]; };
+        map_front_t front(compare);
+
+        double push = chrono_mops(n, [&](){
+            for( size_t i=0; i<n; ++i) {
+                point_t p = grid.point(i);
+                costs[p] = first[i];
+                front.push(p);
+            }
+        });
+        // Changing the costs in place breaks the heap, which thus needs to be rebuilt.
+        double update = chrono_mops(n, [&](){
+            for( size_t i=0; i<n; ++i) {
+                costs[grid.point(i)] = second[i];
+            }
+            front = map_front_t(compare, std::vector<point_t>());
+            for( size_t i=0; i<n; ++i) {
+                front.push(grid.point(i));
+            }
+        });
+        double pop = chrono_mops(n, [&](){
+            while( not front.empty() ) {
+                front.pop();
+            }
+        });
+        std::cout << "priority_queue+map\t" << push << "\t" << update << "\t" << pop << std::endl;
+    }
+
+    {
+        front_t front(n);
+        double push = chrono_mops(n, [&](){
+            for( size_t i=0; i<n; ++i) {
+                front.push(i, first[i]);
+            }
+        });
+        double update = chrono_mops(n, [&](){
+            for( size_t i=0; i<n; ++i) {
+                front.update(i, second[i]);
+            }
+        });
+        double pop = chrono_mops(n, [&](){
+            while( not front.empty() ) {
+                front.pop();
+            }
+        });
+        std::cout << "heap_front<4>\t" << push << "\t" << update << "\t" << pop << std::endl;
+    }
+}
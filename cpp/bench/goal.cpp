@@ -0,0 +1,57 @@
+/** Compare point-to-point A* queries against full propagations.
+
+    On a side×side grid, the costs from the center are computed once on the whole grid,
+    then A* queries are run toward goals at increasing distances from the center,
+    with the 8-neighbors Dijkstra and exact fast marching (with the consistent heuristic scale of each),
+    allocating the costs and the front for each query, or in a reused workspace.
+    The number of accepted points, the times, and the difference with the full propagation
+    are printed (in TSV).
+
+    Usage: bench_goal [side=512]
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#include "code.h"
+#include "workspace.h"
+#include "timing.h"
+
+int main(int argc, char** argv)
+{
+    unsigned int side = argc > 1 ? std::stoi(argv[1]) : 512;
+
+    grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+    point_t seed = grid.point(side/2, side/2);
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+
+    using transit_f = std::function< double(const point_t &, const neighbors_t &, const costs_t &) >;
+    using touched_transit_f = std::function< double(const point_t &, const neighbors_t &, const touched_costs<double> &) >;
+    struct transit_case_t {std::string name; transit_f plain; touched_transit_f touched; double scale;};
+    std::vector<transit_case_t> transits{
+        {"on_edge", transit_on_edge, transit_on_edge_of<double,touched_costs>, 1},
+        {"in_simplex_exact", transit_in_simplex_exact, transit_in_simplex_exact_of<double,touched_costs>, simplex_heuristic_scale<octo_stencil>()}
+    };
+    workspace_t<> workspace;
+
+    std::cout << "transit\tdistance\taccepted\tms\tworkspace_ms\tcost\tfull_accepted\tfull_ms\tfull_cost\trel_diff" << std::endl;
+    for( auto & t : transits ) {
+        costs_t full(grid);
+        double full_ms = chrono_ms([&](){ full = algo_run(grid, seed, grid.size(), eight, t.plain, nullptr, nullptr); });
+        for( unsigned int d = 4; d < side/2; d *= 2 ) {
+            // Off the diagonal, to avoid the trivially straight paths.
+            point_t goal = grid.point(side/2 + d, side/2 + d/2);
+            goal_cost_t g;
+            double ms = chrono_ms([&](){ g = algo_goal(grid, seed, goal, grid.size(), eight, t.plain, t.scale); });
+            // The first query sizes the workspace.
+            algo_goal(workspace, grid, seed, goal, grid.size(), eight, t.touched, t.scale);
+            double workspace_ms = chrono_ms([&](){ g = algo_goal(workspace, grid, seed, goal, grid.size(), eight, t.touched, t.scale); });
+            std::cout << t.name << "\t" << distance(seed, goal) << "\t" << g.expanded << "\t" << ms << "\t" << workspace_ms << "\t" << g.cost
+                << "\t" << grid.size() << "\t" << full_ms << "\t" << full.at(goal)
+                << "\t" << std::abs(g.cost - full.at(goal)) / full.at(goal) << std::endl;
+        }
+    }
+}
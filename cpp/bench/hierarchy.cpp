@@ -0,0 +1,69 @@
+/** Compare the coarse-to-fine queries against the full resolution A*.
+
+    On a side×side grid, uniform or crossed by two thick walls (forcing a detour),
+    queries between opposite corners are run with the full resolution A* (see algo_goal),
+    then coarse to fine, with increasing coarsening factors (and a corridor of 2 coarse points),
+    with the 8-neighbors Dijkstra and exact fast marching.
+    The number of accepted points, the points and bytes allocated on the fine grid, the time,
+    the relative error of the cost and the speedup over the full resolution are printed (in TSV).
+
+    Usage: bench_hierarchy [side=2048]
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#include "code.h"
+#include "hierarchy.h"
+#include "timing.h"
+
+int main(int argc, char** argv)
+{
+    long side = argc > 1 ? std::stol(argv[1]) : 2048;
+
+    grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+    point_t seed = grid.point(side/16, side/8);
+    point_t goal = grid.point(side - side/16, side - side/8);
+
+    using transit_f = std::function< double(const point_t &, const neighbors_t &, const costs_t &) >;
+    struct transit_case_t {std::string name; transit_f full; corridor_transit_f corridor;};
+    std::vector<transit_case_t> transits{
+        {"on_edge", transit_on_edge, transit_on_edge_of<double,corridor_costs>},
+        {"in_simplex_exact", transit_in_simplex_exact, transit_in_simplex_exact_of<double,corridor_costs>}
+    };
+    // Two walls, a sixteenth of the side thick, leaving gaps on opposite sides.
+    auto walls = [&grid,side] (const point_t & p) {
+        long i = grid.i(p), j = grid.j(p);
+        long t = side / 16;
+        return not ((side/3 <= i and i < side/3 + t and j > side/4) or (2*side/3 <= i and i < 2*side/3 + t and j < 3*side/4));
+    };
+    std::vector< std::pair<std::string, std::function< bool(const point_t &) > > > domains{
+        {"uniform", nullptr}, {"walls", walls}
+    };
+
+    std::ostream & log = std::cout;
+    log << "transit\tdomain\tside\tfactor\taccepted\tfine_points\tfine_MiB\tms\tcost\tfull_accepted\tfull_ms\tfull_cost\trel_error\tspeedup" << std::endl;
+    for( auto & t : transits ) {
+        for( auto & d : domains ) {
+            auto free = [&d] (const point_t & p) {return not d.second or d.second(p);};
+            auto neighbors = [&] (const point_t & p) {
+                return neighbors_grid_if<octo_stencil>(p, grid, [&] (size_t idx) {return free(grid.point(idx));});
+            };
+            goal_cost_t full;
+            double full_ms = chrono_ms([&](){ full = algo_goal(grid, seed, goal, grid.size(), neighbors, t.full); });
+
+            for( unsigned int factor = 4; factor <= 64; factor *= 2 ) {
+                hierarchy_cost_t h;
+                double ms = chrono_ms([&](){ h = coarse_to_fine<octo_stencil>(grid, seed, goal, t.corridor, factor, 2, d.second); });
+                log << t.name << "\t" << d.first << "\t" << side << "\t" << factor
+                    << "\t" << h.coarse_expanded + h.fine_expanded << "\t" << h.fine_points
+                    << "\t" << h.fine_bytes / (1024.0*1024.0) << "\t" << ms << "\t" << h.cost
+                    << "\t" << full.expanded << "\t" << full_ms << "\t" << full.cost
+                    << "\t" << (h.cost - full.cost) / full.cost << "\t" << full_ms / ms << std::endl;
+            }
+        }
+    }
+}
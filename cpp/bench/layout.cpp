@@ -0,0 +1,123 @@
+/** Compare the storage layouts of the grids, on grids larger than the caches.
+
+    On side×side grids, the 8-neighbors Dijkstra and exact fast marching are run from the center,
+    with the costs and the front's positions stored in row-major order, in tiles, or in Z-order.
+    The time, the time per node and the cache misses (from the hardware counters, if the system
+    gives access to them, NA otherwise) are printed (in TSV).
+
+    The costs and the positions take 16 bytes per point: to exceed the last level cache,
+    side² * 16 bytes should be larger than it (e.g. 8192 for caches up to 1 GiB).
+
+    Usage: bench_layout [max_side=4096]
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <chrono>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "code.h"
+
+/** Count the cache misses of the current thread, in user space. */
+class cache_misses_t
+{
+    public:
+        cache_misses_t()
+        {
+            struct perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            _fd = static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+        ~cache_misses_t() {if( available() ) {::close(_fd);}}
+
+        bool available() const {return _fd >= 0;}
+
+        void start()
+        {
+            if( available() ) {
+                ::ioctl(_fd, PERF_EVENT_IOC_RESET, 0);
+                ::ioctl(_fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+
+        //! The number of misses since start, or -1 if not available.
+        long long stop()
+        {
+            long long count = -1;
+            if( available() ) {
+                ::ioctl(_fd, PERF_EVENT_IOC_DISABLE, 0);
+                if( ::read(_fd, &count, sizeof(count)) != sizeof(count) ) {
+                    count = -1;
+                }
+            }
+            return count;
+        }
+
+    protected:
+        int _fd;
+};
+
+int main(int argc, char** argv)
+{
+    unsigned int max_side = argc > 1 ? std::stoi(argv[1]) : 4096;
+
+    std::vector< std::pair<std::string, std::function< double(const point_t &, const neighbors_t &, const costs_t &) > > > transits{
+        {"on_edge", transit_on_edge}, {"in_simplex_exact", transit_in_simplex_exact}
+    };
+    struct layout_case_t {std::string name; layout_t layout; unsigned int tile_log2;};
+    std::vector<layout_case_t> layouts{
+        {"row_major", layout_t::row_major, 0},
+        {"tiled_8", layout_t::tiled, 3},
+        {"tiled_16", layout_t::tiled, 4},
+        {"tiled_64", layout_t::tiled, 6},
+        {"morton", layout_t::morton, 0}
+    };
+
+    cache_misses_t misses;
+    std::ostream & log = std::cout;
+    log << "transit\tlayout\tside\tMiB\tms\tns_per_node\tcache_misses\tmisses_per_node" << std::endl;
+    for( unsigned int side = 1024; side <= max_side; side *= 2 ) {
+        for( auto & t : transits ) {
+            for( auto & l : layouts ) {
+                grid_t grid(make_point(0,0), make_point(side-1,side-1), 1, l.layout, l.tile_log2);
+                point_t seed = grid.point(side/2, side/2);
+                auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+
+                costs_t costs(grid);
+                front_t front(grid);
+                misses.start();
+                auto start = std::chrono::steady_clock::now();
+                costs[seed] = 0;
+                front.push(grid.index(seed), 0);
+                // Without progress output, which would hide the memory accesses.
+                algo_propagate(costs, nullptr, front, grid.size(), eight, t.second, nullptr);
+                auto stop = std::chrono::steady_clock::now();
+                long long count = misses.stop();
+                double ms = std::chrono::duration<double,std::milli>(stop - start).count();
+                double nodes = static_cast<double>(grid.width * grid.height);
+
+                log << t.first << "\t" << l.name << "\t" << side << "\t" << grid.size() * 16 / (1024*1024)
+                    << "\t" << ms << "\t" << ms * 1e6 / nodes;
+                if( count >= 0 ) {
+                    log << "\t" << count << "\t" << count / nodes << std::endl;
+                } else {
+                    log << "\tNA\tNA" << std::endl;
+                }
+            }
+        }
+    }
+}
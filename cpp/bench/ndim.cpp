@@ -0,0 +1,58 @@
+/** Propagation on 3D volumes, with the 6, 18 and 26 neighbors stencils.
+
+    On a side³ volume, the costs from the center are computed on edges and in simplexes (tetrahedral updates),
+    and the time, the time per node, the memory held by the costs and the front,
+    and the max error against the euclidean distance are printed (in TSV).
+
+    Usage: bench_ndim [side=64]
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#include "code.h"
+#include "ndim.h"
+#include "timing.h"
+
+int main(int argc, char** argv)
+{
+    unsigned int side = argc > 1 ? std::stoi(argv[1]) : 64;
+
+    grid_n<3> volume({{0,0,0}}, {{side-1.0,side-1.0,side-1.0}}, 1);
+    point_n<3> center = volume.point(coords_n<3>{{side/2,side/2,side/2}});
+    // The costs, and the position of each node in the front.
+    double mib = volume.size() * (sizeof(double) + sizeof(size_t)) / (1024.0*1024.0);
+
+    std::vector< std::pair<std::string, stencil_n<3>> > stencils{
+        {"6", axis_stencil<3>()}, {"18", edge_stencil()}, {"26", cube_stencil<3>()}
+    };
+
+    std::cout << "neighbors\ttransit\tside\tnodes\tms\tns_per_node\tMiB\tmax_error" << std::endl;
+    for( auto & s : stencils ) {
+        const stencil_n<3> & stencil = s.second;
+        auto around = [&](const point_n<3> & p) {return neighbors_grid_n(p, volume, stencil);};
+
+        auto measure = [&] (const std::string & transit, costs_n<3> & costs, double ms) {
+            double error = 0;
+            for( size_t i = 0; i < costs.size(); ++i ) {
+                error = std::max(error, std::abs(costs.at(i) - distance(volume.point(i), center)));
+            }
+            std::cout << s.first << "\t" << transit << "\t" << side << "\t" << volume.size() << "\t" << ms
+                << "\t" << ms * 1e6 / volume.size() << "\t" << mib << "\t" << error << std::endl;
+        };
+
+        {
+            costs_n<3> costs(volume);
+            double ms = chrono_ms([&](){ costs = algo_run_n(volume, center, volume.size(), around, transit_on_edge_n<3>); });
+            measure("on_edge", costs, ms);
+        }
+        {
+            costs_n<3> costs(volume);
+            double ms = chrono_ms([&](){ costs = algo_run_n(volume, center, volume.size(), around, transit_in_simplex_n<3>); });
+            measure("in_simplex", costs, ms);
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/** Compare the binary output of the costs against pretty printing.
+
+    The costs of a side×side grid (filled with the distance to its center, not propagated)
+    are written in a file, with grid_print, as npy float32 and float64 through a stream,
+    and copied into a memory-mapped file.
+    The time of each is printed (in TSV), along with the throughput.
+
+    Usage: bench_output [side=4096] [path=bench_output.bin]
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "code.h"
+#include "output.h"
+#include "timing.h"
+
+void print(const std::string & name, double s, size_t bytes)
+{
+    std::cout << name << "\t" << s * 1000 << "\t" << bytes / s / (1 << 20) << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int side = argc > 1 ? std::stoi(argv[1]) : 4096;
+    std::string path = argc > 2 ? argv[2] : "bench_output.bin";
+
+    grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+    costs_t costs(grid);
+    point_t center = grid.point(side/2, side/2);
+    for( size_t i = 0; i < costs.size(); ++i ) {
+        costs[i] = distance(grid.point(i), center);
+    }
+
+    std::cout << "output\tms\tMiB_per_s" << std::endl;
+
+    // Pretty printing is way too slow on large grids, it is only timed on the first rows.
+    size_t rows = std::min<size_t>(grid.height, 256);
+    grid_t band(make_point(0,0), make_point(side-1,rows-1), 1);
+    costs_t head(band);
+    std::copy(costs.data(), costs.data() + head.size(), &head[0]);
+    double s = chrono_s([&](){
+        std::ofstream out(path);
+        grid_print(head, out);
+    });
+    print("grid_print (extrapolated)", s * grid.height / rows, costs.size() * 8);
+
+    s = chrono_s([&](){ costs_write<float>(costs, path, costs_format_t::npy); });
+    print("npy_float32", s, costs_bytes<float>(grid, costs_format_t::npy));
+
+    s = chrono_s([&](){ costs_write<double>(costs, path, costs_format_t::npy); });
+    print("npy_float64", s, costs_bytes<double>(grid, costs_format_t::npy));
+
+    s = chrono_s([&](){ costs_write<float>(costs, path, costs_format_t::raw); });
+    print("raw_float32", s, costs_bytes<float>(grid, costs_format_t::raw));
+
+    size_t bytes = costs_bytes<float>(grid, costs_format_t::npy);
+    s = chrono_s([&](){
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if( fd < 0 or ::ftruncate(fd, bytes) != 0 ) {
+            throw std::runtime_error("cannot create " + path);
+        }
+        void* addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if( addr == MAP_FAILED ) {
+            throw std::runtime_error("cannot map " + path);
+        }
+        costs_copy<float>(costs, static_cast<char*>(addr), costs_format_t::npy);
+        ::munmap(addr, bytes);
+    });
+    print("mmap_npy_float32", s, bytes);
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,71 @@
+/** Throughput of the batch extraction of shortest paths.
+
+    On a side×side grid, the costs from the center are computed once,
+    with the 8-neighbors Dijkstra and exact fast marching,
+    then the paths from many random targets are extracted in parallel,
+    along the parents and along the gradient, respectively.
+    The time to compute the parents, the time to extract all the paths,
+    the number of paths per second and their mean number of points are printed (in TSV),
+    for an increasing number of workers.
+
+    Usage: bench_paths [side=512] [targets=20000]
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <random>
+
+#include "code.h"
+#include "paths.h"
+#include "timing.h"
+
+double mean_points(const std::vector<path_t> & paths)
+{
+    double total = 0;
+    for( auto & path : paths ) {
+        total += path.size();
+    }
+    return total / paths.size();
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int side = argc > 1 ? std::stoi(argv[1]) : 512;
+    unsigned int nb = argc > 2 ? std::stoi(argv[2]) : 20000;
+
+    grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+    point_t seed = grid.point(side/2, side/2);
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<long> coord(0, side-1);
+    std::vector<point_t> targets;
+    for( unsigned int t = 0; t < nb; ++t ) {
+        targets.push_back(grid.point(coord(rng), coord(rng)));
+    }
+
+    costs_t graph = algo_run(grid, seed, grid.size(), eight, transit_on_edge, nullptr, nullptr);
+    costs_t exact = algo_run(grid, seed, grid.size(), eight, transit_in_simplex_exact, nullptr, nullptr);
+
+    std::cout << "method\tworkers\tparents_ms\tpaths\tpaths_ms\tpaths_per_s\tmean_points" << std::endl;
+    unsigned int max_workers = std::max(1U, std::thread::hardware_concurrency());
+    for( unsigned int workers = 1; workers <= max_workers; workers *= 2 ) {
+        work_stealing_pool pool(workers);
+
+        parents_t parents;
+        double parents_ms = chrono_ms([&](){ parents = paths_parents(graph, pool); });
+        std::vector<path_t> paths;
+        double ms = chrono_ms([&](){
+            paths = paths_run(targets, pool, [&] (const point_t & target) {return path_parents(parents, graph, target);});
+        });
+        std::cout << "parents\t" << workers << "\t" << parents_ms << "\t" << paths.size() << "\t" << ms
+            << "\t" << paths.size() / ms * 1000 << "\t" << mean_points(paths) << std::endl;
+
+        ms = chrono_ms([&](){ paths = paths_in_simplex(exact, targets, pool); });
+        std::cout << "gradient\t" << workers << "\t" << 0 << "\t" << paths.size() << "\t" << ms
+            << "\t" << paths.size() / ms * 1000 << "\t" << mean_points(paths) << std::endl;
+    }
+}
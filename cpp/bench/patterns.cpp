@@ -0,0 +1,193 @@
+/** Compare the four compositions of the same algorithms, across grid sizes.
+
+    This source is compiled once per composition (bench_functional, bench_strategy,
+    bench_policies and bench_crtp), by including the demo file itself without its main.
+    Each run is timed after a warm-up run, repeated until either the number of repetitions
+    or the time budget is reached (but at least 3 times), and the median and 95th percentile
+    are reported, along with the median time per accepted node.
+    The sum of the costs is also reported, so that the compositions can be cross-checked.
+
+    Usage: bench_<pattern> [max_side=4096] [repetitions=11] [budget_s=2] [csv|json] [header|noheader]
+
+    To be meaningful, configure with -DCMAKE_BUILD_TYPE=Release.
+    The bench_patterns target runs the four of them and gathers the results in patterns.csv.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <chrono>
+
+#define ALGOPATTERN_NO_MAIN
+#if defined(BENCH_FUNCTIONAL)
+#include "functional.cpp"
+const std::string pattern = "functional";
+#elif defined(BENCH_STRATEGY)
+#include "strategy.cpp"
+const std::string pattern = "strategy";
+#elif defined(BENCH_POLICIES)
+#include "policies.cpp"
+const std::string pattern = "policies";
+#elif defined(BENCH_CRTP)
+#include "crtp.cpp"
+const std::string pattern = "crtp";
+#else
+#error "Define one of BENCH_FUNCTIONAL, BENCH_STRATEGY, BENCH_POLICIES or BENCH_CRTP."
+#endif
+
+struct bench_options_t
+{
+    unsigned int max_side = 4096;
+    unsigned int repetitions = 11;
+    double budget_s = 2;
+    bool json = false;
+    bool header = true;
+};
+
+class bench_report_t
+{
+    public:
+        bench_report_t(const bench_options_t & options, std::ostream & out) : _options(options), _out(out), _rows(0)
+        {
+            if( _options.json ) {
+                _out << "[" << std::endl;
+            } else if( _options.header ) {
+                _out << "pattern,transit,side,nodes,repetitions,median_ms,p95_ms,ns_per_node,checksum" << std::endl;
+            }
+        }
+
+        ~bench_report_t()
+        {
+            if( _options.json ) {
+                _out << std::endl << "]" << std::endl;
+            }
+        }
+
+        //! Time the given run, which returns the computed costs.
+        template<typename F>
+        void measure(const std::string & transit, unsigned int side, F run)
+        {
+            // Warm-up, also used to count the accepted nodes.
+            costs_t costs = run();
+            size_t nodes = 0;
+            double checksum = 0;
+            for( size_t i = 0; i < costs.size(); ++i ) {
+                if( costs[i] != std::numeric_limits<double>::infinity() ) {
+                    nodes++;
+                    checksum += costs[i];
+                }
+            }
+
+            std::vector<double> ms;
+            double total_s = 0;
+            while( ms.size() < 3 or (ms.size() < _options.repetitions and total_s < _options.budget_s) ) {
+                auto start = std::chrono::steady_clock::now();
+                costs_t c = run();
+                auto stop = std::chrono::steady_clock::now();
+                ms.push_back( std::chrono::duration<double,std::milli>(stop - start).count() );
+                total_s += ms.back() / 1000;
+            }
+            std::sort(ms.begin(), ms.end());
+            double median = ms[ms.size()/2];
+            double p95 = ms[static_cast<size_t>(std::ceil(0.95 * ms.size())) - 1];
+            double ns_per_node = median * 1e6 / nodes;
+
+            if( _options.json ) {
+                _out << (_rows == 0 ? "" : ",\n")
+                    << "  {\"pattern\": \"" << pattern << "\", \"transit\": \"" << transit << "\""
+                    << ", \"side\": " << side << ", \"nodes\": " << nodes << ", \"repetitions\": " << ms.size()
+                    << ", \"median_ms\": " << median << ", \"p95_ms\": " << p95 << ", \"ns_per_node\": " << ns_per_node
+                    << ", \"checksum\": " << std::setprecision(12) << checksum << std::setprecision(6) << "}";
+            } else {
+                _out << pattern << "," << transit << "," << side << "," << nodes << "," << ms.size()
+                    << "," << median << "," << p95 << "," << ns_per_node
+                    << "," << std::setprecision(12) << checksum << std::setprecision(6) << std::endl;
+            }
+            _rows++;
+        }
+
+    protected:
+        const bench_options_t & _options;
+        std::ostream & _out;
+        size_t _rows;
+};
+
+/** Run the 8-neighbors Dijkstra and exact fast marching on a SIDE×SIDE grid, from its center.
+
+    The side is a template parameter, because the policies composition needs it at compile time. */
+template<int SIDE>
+void bench_side(bench_report_t & report)
+{
+    const grid_t grid({0,0}, {SIDE-1,SIDE-1}, 1);
+    const point_t seed = grid.point(SIDE/2, SIDE/2);
+    const unsigned int iterations = grid.size();
+
+#if defined(BENCH_FUNCTIONAL)
+    auto eight = neighbors::make(neighbors::octo_grid, grid);
+    auto graph = transit::make(transit::on_edge);
+    auto exact = transit::make(transit::in_simplex_exact);
+    report.measure("on_edge",          SIDE, [&](){ return algo(grid, eight, graph, seed, iterations, nullptr); });
+    report.measure("in_simplex_exact", SIDE, [&](){ return algo(grid, eight, exact, seed, iterations, nullptr); });
+
+#elif defined(BENCH_STRATEGY)
+    neighbors::octo_grid eight(grid);
+    transit::on_edge graph;
+    transit::in_simplex_exact exact;
+    algo dijkstra(eight, graph);
+    algo fast_marching(eight, exact);
+    report.measure("on_edge",          SIDE, [&](){ return dijkstra(seed, iterations, nullptr); });
+    report.measure("in_simplex_exact", SIDE, [&](){ return fast_marching(seed, iterations, nullptr); });
+
+#elif defined(BENCH_POLICIES)
+    algo< neighbors::octo_grid<1,0,0,SIDE-1,SIDE-1>, transit::on_edge > dijkstra;
+    algo< neighbors::octo_grid<1,0,0,SIDE-1,SIDE-1>, transit::in_simplex_exact > fast_marching;
+    report.measure("on_edge",          SIDE, [&](){ return dijkstra(seed, iterations, nullptr, nullptr); });
+    report.measure("in_simplex_exact", SIDE, [&](){ return fast_marching(seed, iterations, nullptr, nullptr); });
+
+#elif defined(BENCH_CRTP)
+    neighbors::octo_grid eight(grid);
+    transit::on_edge graph;
+    transit::in_simplex_exact exact;
+    algo<neighbors::octo_grid,transit::on_edge> dijkstra(eight, graph);
+    algo<neighbors::octo_grid,transit::in_simplex_exact> fast_marching(eight, exact);
+    report.measure("on_edge",          SIDE, [&](){ return dijkstra(seed, iterations, nullptr); });
+    report.measure("in_simplex_exact", SIDE, [&](){ return fast_marching(seed, iterations, nullptr); });
+#endif
+}
+
+template<int... SIDES>
+struct bench_sides;
+
+template<>
+struct bench_sides<>
+{
+    static void run(bench_report_t &, unsigned int) {}
+};
+
+template<int SIDE, int... SIDES>
+struct bench_sides<SIDE, SIDES...>
+{
+    static void run(bench_report_t & report, unsigned int max_side)
+    {
+        if( SIDE <= static_cast<int>(max_side) ) {
+            bench_side<SIDE>(report);
+            bench_sides<SIDES...>::run(report, max_side);
+        }
+    }
+};
+
+int main(int argc, char** argv)
+{
+    bench_options_t options;
+    if( argc > 1 ) { options.max_side    = std::stoi(argv[1]); }
+    if( argc > 2 ) { options.repetitions = std::stoi(argv[2]); }
+    if( argc > 3 ) { options.budget_s    = std::stod(argv[3]); }
+    if( argc > 4 ) { options.json        = std::string(argv[4]) == "json"; }
+    if( argc > 5 ) { options.header      = std::string(argv[5]) != "noheader"; }
+
+    // The runs print no progress, which would be timed along.
+    bench_report_t report(options, std::cout);
+    bench_sides<20,64,256,1024,4096>::run(report, options.max_side);
+}
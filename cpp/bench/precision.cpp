@@ -0,0 +1,62 @@
+/** Compare the propagation in single and double precision.
+
+    On side×side grids, the 8-neighbors Dijkstra and exact fast marching are run from the center,
+    with the costs in double and in single precision.
+    The time, the time per node, the memory held by the costs,
+    and the max deviation of the single precision costs from the double precision ones are printed (in TSV).
+
+    Usage: bench_precision [max_side=2048]
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#include "code.h"
+#include "timing.h"
+
+//! Propagate from the seed, without printing progress.
+template<typename Real, typename N, typename T>
+costs_of<Real> run(const grid_t & grid, const point_t & seed, N & neighbors, T & transit)
+{
+    costs_of<Real> costs(grid);
+    front_t front(grid);
+    costs[seed] = 0;
+    front.push(grid.index(seed), 0);
+    algo_propagate(costs, nullptr, front, grid.size(), neighbors, transit, nullptr);
+    return costs;
+}
+
+//! Run in both precisions from the center, and print the measures.
+template<typename TD, typename TF>
+void measure(const grid_t & grid, const std::string & transit, TD & double_transit, TF & float_transit)
+{
+    point_t seed = grid.point(grid.width/2, grid.height/2);
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+    double nodes = static_cast<double>(grid.size());
+
+    costs_t reference(grid);
+    costs_of<float> single(grid);
+    double ms_d = chrono_ms([&](){ reference = run<double>(grid, seed, eight, double_transit); });
+    double ms_f = chrono_ms([&](){ single = run<float>(grid, seed, eight, float_transit); });
+    deviation_t deviation = costs_deviation(single, reference);
+
+    std::cout << transit << "\tdouble\t" << grid.width << "\t" << ms_d << "\t" << ms_d * 1e6 / nodes
+        << "\t" << nodes * sizeof(double) / (1024*1024) << "\t0\t0" << std::endl;
+    std::cout << transit << "\tfloat\t" << grid.width << "\t" << ms_f << "\t" << ms_f * 1e6 / nodes
+        << "\t" << nodes * sizeof(float) / (1024*1024) << "\t" << deviation.max_abs << "\t" << deviation.max_rel << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int max_side = argc > 1 ? std::stoi(argv[1]) : 2048;
+
+    std::cout << "transit\tscalar\tside\tms\tns_per_node\tcosts_MiB\tmax_deviation\tmax_rel_deviation" << std::endl;
+    for( unsigned int side = 256; side <= max_side; side *= 2 ) {
+        grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+        measure(grid, "on_edge", transit_on_edge_of<double>, transit_on_edge_of<float>);
+        measure(grid, "in_simplex_exact", transit_in_simplex_exact_of<double>, transit_in_simplex_exact_of<float>);
+    }
+}
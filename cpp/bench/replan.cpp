@@ -0,0 +1,68 @@
+/** Compare incremental replanning against propagating again from scratch.
+
+    On a side×side grid with a speed field, small square obstacles (of the given width)
+    are added at random places, one at a time, and the costs are either repaired or computed again.
+    The times and the number of transits are printed (in TSV).
+
+    Usage: bench_replan [side=512] [edits=10] [width=4]
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <random>
+
+#include "code.h"
+#include "speed.h"
+#include "replan.h"
+#include "timing.h"
+
+int main(int argc, char** argv)
+{
+    unsigned int side = argc > 1 ? std::stoi(argv[1]) : 512;
+    unsigned int edits = argc > 2 ? std::stoi(argv[2]) : 10;
+    unsigned int width = argc > 3 ? std::stoi(argv[3]) : 4;
+
+    grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+    point_t seed = grid.point(side/2, side/2);
+    speed_field_t field(grid, std::vector<float>(grid.size(), 1));
+    auto neighbors = [&grid,&field](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid,field);};
+    auto around = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+    auto exact = [&field](const point_t& p, const neighbors_t& n, const costs_t& c) {return transit_in_simplex_exact_speed(p,n,c,field);};
+
+    replanner_t<> replanner(grid, seed, neighbors, exact, 1e-9, around);
+
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<long> where(0, side - width - 1);
+    std::cout << "edit\trepair_ms\trepair_transits\tscratch_ms\tscratch_transits\tmax_diff" << std::endl;
+    for( unsigned int e = 0; e < edits; ++e ) {
+        long i0 = where(rng);
+        long j0 = where(rng);
+        std::vector<point_t> changed;
+        for( long i = i0; i < i0 + width; ++i ) {
+            for( long j = j0; j < j0 + width; ++j ) {
+                if( grid.point(i,j) != seed ) {
+                    field.set_speed(grid.index(i,j), 0);
+                    changed.push_back(grid.point(i,j));
+                }
+            }
+        }
+        size_t repair_transits = 0;
+        double repair = chrono_ms([&](){ repair_transits = replanner.update(changed); });
+
+        size_t scratch_transits = 0;
+        auto counted = [&](const point_t& p, const neighbors_t& n, const costs_t& c) {scratch_transits++; return exact(p,n,c);};
+        costs_t costs(grid);
+        double scratch = chrono_ms([&](){ costs = algo_run(grid, seed, grid.size(), neighbors, counted, nullptr, nullptr); });
+
+        double diff = 0;
+        for( size_t i = 0; i < costs.size(); ++i ) {
+            if( std::isfinite(costs[i]) or std::isfinite(replanner.costs().at(i)) ) {
+                diff = std::max(diff, std::abs(costs[i] - replanner.costs().at(i)));
+            }
+        }
+        std::cout << e << "\t" << repair << "\t" << repair_transits << "\t" << scratch << "\t" << scratch_transits << "\t" << diff << std::endl;
+    }
+}
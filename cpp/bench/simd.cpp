@@ -0,0 +1,68 @@
+/** Compare the vectorized transits against the scalar ones.
+
+    All the transits are evaluated on every point of an already computed cost field,
+    with the 8-neighborhood, for each set of kernels available on this CPU.
+    The time per call and the largest difference with the scalar transit are printed.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <queue>
+#include <cassert>
+#include <functional>
+
+#include "code.h"
+#include "simd.h"
+#include "timing.h"
+
+template<typename F>
+std::pair<double,double> chrono_ns_diff(const grid_t & grid, const std::vector<double> & reference, F f)
+{
+    double max_diff = 0;
+    double ns = chrono_ns([&](){
+        for( size_t idx = 0; idx < grid.size(); ++idx ) {
+            max_diff = std::max(max_diff, std::abs(f(idx) - reference[idx]));
+        }
+    });
+    return std::make_pair(ns / grid.size(), max_diff);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int side = argc > 1 ? std::stoi(argv[1]) : 256;
+    double eps = 1/100.0;
+
+    grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+    point_t seed = grid.point(side/2, side/2);
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+
+    costs_t costs = algo_run(grid, seed, grid.size(), eight, transit_in_simplex_exact, nullptr, nullptr);
+
+    std::vector<neighbors_t> around;
+    for( size_t idx = 0; idx < grid.size(); ++idx) {
+        around.push_back( eight(grid.point(idx)) );
+    }
+    std::vector<double> edge(grid.size()), simplex(grid.size());
+    for( size_t idx = 0; idx < grid.size(); ++idx) {
+        edge[idx]    = transit_on_edge   (grid.point(idx), around[idx], costs);
+        simplex[idx] = transit_in_simplex(grid.point(idx), around[idx], costs, eps);
+    }
+
+    std::cout << "transit\tkernels\tns_per_call\tmax_diff" << std::endl;
+    auto r = chrono_ns_diff(grid, edge, [&](size_t idx){ return transit_on_edge(grid.point(idx), around[idx], costs); });
+    std::cout << "on_edge\treference\t" << r.first << "\t" << r.second << std::endl;
+    for( const simd_kernels_t & k : simd_available() ) {
+        r = chrono_ns_diff(grid, edge, [&](size_t idx){ return transit_on_edge_simd(grid.point(idx), around[idx], costs, k); });
+        std::cout << "on_edge\t" << k.name << "\t" << r.first << "\t" << r.second << std::endl;
+    }
+
+    r = chrono_ns_diff(grid, simplex, [&](size_t idx){ return transit_in_simplex(grid.point(idx), around[idx], costs, eps); });
+    std::cout << "in_simplex\treference\t" << r.first << "\t" << r.second << std::endl;
+    for( const simd_kernels_t & k : simd_available() ) {
+        r = chrono_ns_diff(grid, simplex, [&](size_t idx){ return transit_in_simplex_simd(grid.point(idx), around[idx], costs, eps, k); });
+        std::cout << "in_simplex\t" << k.name << "\t" << r.first << "\t" << r.second << std::endl;
+    }
+}
@@ -0,0 +1,57 @@
+/** Show where the time goes in a propagation, with the instrumented algorithms.
+
+    Compiled with ALGOPATTERN_STATS, the 8-neighbors Dijkstra and exact fast marching
+    are run on the whole grid, both with algo_run and with the policies composition,
+    and their counters and phase timers are printed (in TSV).
+    The total time, with and without asking for stats, shows the cost of the timers themselves.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#define ALGOPATTERN_NO_MAIN
+#include "policies.cpp"
+#include "timing.h"
+
+void print(const std::string & name, const algo_stats_t & s, double total_ms, double plain_ms)
+{
+    std::cout << name
+        << "\t" << s.accepted << "\t" << s.neighborhoods << "\t" << s.transits
+        << "\t" << s.pushes << "\t" << s.pops << "\t" << s.max_front
+        << "\t" << s.neighbors_time * 1000 << "\t" << s.transit_time * 1000 << "\t" << s.front_time * 1000
+        << "\t" << total_ms << "\t" << plain_ms << std::endl;
+}
+
+const int side = 256;
+
+int main()
+{
+    grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+    point_t seed = grid.point(side/2, side/2);
+    unsigned int iterations = grid.size();
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+
+    algo< neighbors::octo_grid<1,0,0,side-1,side-1>, transit::on_edge > dijkstra;
+    algo< neighbors::octo_grid<1,0,0,side-1,side-1>, transit::in_simplex_exact > fast_marching;
+
+    algo_stats_t s[4];
+    double ms[4], plain[4];
+    ms[0] = chrono_ms([&](){ algo_run(grid, seed, iterations, eight, transit_on_edge, &s[0], nullptr); });
+    plain[0] = chrono_ms([&](){ algo_run(grid, seed, iterations, eight, transit_on_edge, nullptr, nullptr); });
+    ms[1] = chrono_ms([&](){ algo_run(grid, seed, iterations, eight, transit_in_simplex_exact, &s[1], nullptr); });
+    plain[1] = chrono_ms([&](){ algo_run(grid, seed, iterations, eight, transit_in_simplex_exact, nullptr, nullptr); });
+    ms[2] = chrono_ms([&](){ dijkstra(seed, iterations, &s[2], nullptr); });
+    plain[2] = chrono_ms([&](){ dijkstra(seed, iterations, nullptr, nullptr); });
+    ms[3] = chrono_ms([&](){ fast_marching(seed, iterations, &s[3], nullptr); });
+    plain[3] = chrono_ms([&](){ fast_marching(seed, iterations, nullptr, nullptr); });
+
+    std::cout << "algo\taccepted\tneighborhoods\ttransits\tpushes\tpops\tmax_front"
+        << "\tneighbors_ms\ttransit_ms\tfront_ms\ttotal_ms\twithout_stats_ms" << std::endl;
+    print("algo_run_on_edge",          s[0], ms[0], plain[0]);
+    print("algo_run_in_simplex_exact", s[1], ms[1], plain[1]);
+    print("policies_on_edge",          s[2], ms[2], plain[2]);
+    print("policies_in_simplex_exact", s[3], ms[3], plain[3]);
+}
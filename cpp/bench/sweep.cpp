@@ -0,0 +1,66 @@
+/** Fast sweeping against the propagation of a front.
+
+    All four compositions of neighborhoods and transits are computed over the whole grid,
+    with algo_run, sweep_run and sweep_run_parallel.
+    The elapsed times are printed, along with the largest difference with algo_run.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <queue>
+#include <cassert>
+#include <functional>
+
+#include "code.h"
+#include "sweep.h"
+#include "timing.h"
+
+double max_diff(const costs_t & a, const costs_t & b)
+{
+    double diff = 0;
+    for( size_t idx = 0; idx < a.size(); ++idx ) {
+        diff = std::max(diff, std::abs(a.at(idx) - b.at(idx)));
+    }
+    return diff;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int side = argc > 1 ? std::stoi(argv[1]) : 256;
+    unsigned int sweeps = 100;
+
+    grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+    point_t seed = grid.point(side/3, side/4);
+
+    using neighbors_f = std::function< neighbors_t(const point_t&) >;
+    using transit_f = std::function< double(const point_t &, const neighbors_t &, const costs_t &) >;
+    std::vector< std::pair<std::string,neighbors_f> > neighborhoods{
+        {"4", [&grid](const point_t& p) {return neighbors_grid<quad_stencil>(p,grid);}},
+        {"8", [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);}}
+    };
+    std::vector< std::pair<std::string,transit_f> > transits{
+        {"on_edge", transit_on_edge},
+        {"in_simplex_exact", transit_in_simplex_exact}
+    };
+
+    std::cout << "neighbors\ttransit\tfront_ms\tsweep_ms\tsweep_diff\tparallel_ms\tparallel_diff" << std::endl;
+    for( auto & n : neighborhoods ) {
+        for( auto & t : transits ) {
+            costs_t front(grid), sweep(grid), parallel(grid);
+
+            double front_ms = chrono_ms([&](){ front = algo_run(grid, seed, grid.size(), n.second, t.second, nullptr, nullptr); });
+
+            double sweep_ms = chrono_ms([&](){ sweep = sweep_run(grid, seed, sweeps, n.second, t.second); });
+            double parallel_ms = chrono_ms([&](){ parallel = sweep_run_parallel(grid, seed, sweeps, n.second, t.second); });
+
+            std::cout << n.first << "\t" << t.first
+                << "\t" << front_ms
+                << "\t" << sweep_ms << "\t" << max_diff(front, sweep)
+                << "\t" << parallel_ms << "\t" << max_diff(front, parallel)
+                << std::endl;
+        }
+    }
+}
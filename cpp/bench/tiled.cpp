@@ -0,0 +1,51 @@
+/** Scaling of the tiled propagation with the number of threads.
+
+    An exact 8-neighbors fast marching is computed over the whole grid
+    with algo_run, then with tiled_run from 1 up to the given number of threads.
+    The elapsed times, speedups against a single thread and the largest
+    difference with algo_run are printed.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <queue>
+#include <cassert>
+#include <functional>
+
+#include "code.h"
+#include "tiled.h"
+#include "timing.h"
+
+int main(int argc, char** argv)
+{
+    unsigned int side = argc > 1 ? std::stoi(argv[1]) : 1024;
+    size_t tile_size = argc > 2 ? std::stoi(argv[2]) : 64;
+    unsigned int max_threads = argc > 3 ? std::stoi(argv[3]) : std::max(1U, std::thread::hardware_concurrency());
+
+    grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+    point_t seed = grid.point(side/3, side/4);
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+
+    costs_t front(grid);
+    double front_ms = chrono_ms([&](){ front = algo_run(grid, seed, grid.size(), eight, transit_in_simplex_exact, nullptr, nullptr); });
+
+    std::cout << "threads\ttiled_ms\tspeedup\tfront_ms\tmax_diff" << std::endl;
+    double single_ms = 0;
+    for( unsigned int threads = 1; threads <= max_threads; threads *= 2 ) {
+        costs_t tiled(grid);
+        double tiled_ms = chrono_ms([&](){
+            tiled = tiled_run(grid, seed, tile_size, threads, std::numeric_limits<unsigned int>::max(), eight, transit_in_simplex_exact);
+        });
+        if( threads == 1 ) {
+            single_ms = tiled_ms;
+        }
+        double max_diff = 0;
+        for( size_t idx = 0; idx < grid.size(); ++idx ) {
+            max_diff = std::max(max_diff, std::abs(front.at(idx) - tiled.at(idx)));
+        }
+        std::cout << threads << "\t" << tiled_ms << "\t" << single_ms / tiled_ms << "\t" << front_ms << "\t" << max_diff << std::endl;
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <chrono>
+#include <ratio>
+
+/** Wall-clock time taken by a call, in the given unit (e.g. std::milli). */
+template<typename Period, typename F>
+double chrono_in(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double,Period>(stop - start).count();
+}
+
+template<typename F>
+double chrono_s(F f) {return chrono_in<std::ratio<1>>(f);}
+
+template<typename F>
+double chrono_ms(F f) {return chrono_in<std::milli>(f);}
+
+template<typename F>
+double chrono_ns(F f) {return chrono_in<std::nano>(f);}
@@ -0,0 +1,54 @@
+/** Compare the sampled and the exact simplex transits.
+
+    Both transits are evaluated on every point of an already computed cost field,
+    with the 8-neighborhood, and the time per call and the largest difference
+    between the two operators are printed.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <queue>
+#include <cassert>
+#include <functional>
+#include <chrono>
+
+#include "code.h"
+
+int main(int argc, char** argv)
+{
+    unsigned int side = argc > 1 ? std::stoi(argv[1]) : 128;
+
+    grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+    point_t seed = grid.point(side/2, side/2);
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+
+    costs_t costs = algo_run(grid, seed, grid.size(), eight, transit_in_simplex_exact, nullptr, nullptr);
+
+    std::vector<neighbors_t> around;
+    for( size_t idx = 0; idx < grid.size(); ++idx) {
+        around.push_back( eight(grid.point(idx)) );
+    }
+
+    std::cout << "transit\tns_per_call\tmax_diff" << std::endl;
+    std::vector<double> exact(grid.size());
+    auto start = std::chrono::steady_clock::now();
+    for( size_t idx = 0; idx < grid.size(); ++idx) {
+        exact[idx] = transit_in_simplex_exact(grid.point(idx), around[idx], costs);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    std::cout << "exact\t" << std::chrono::duration<double,std::nano>(stop - start).count() / grid.size() << "\t0" << std::endl;
+
+    for( double eps : {1/10.0, 1/100.0, 1/1000.0}) {
+        double max_diff = 0;
+        start = std::chrono::steady_clock::now();
+        for( size_t idx = 0; idx < grid.size(); ++idx) {
+            double c = transit_in_simplex(grid.point(idx), around[idx], costs, eps);
+            max_diff = std::max(max_diff, c - exact[idx]);
+        }
+        stop = std::chrono::steady_clock::now();
+        std::cout << "eps=" << eps << "\t" << std::chrono::duration<double,std::nano>(stop - start).count() / grid.size() << "\t" << max_diff << std::endl;
+    }
+}
@@ -0,0 +1,81 @@
+/** Queries per second on small grids, with fresh buffers or in a reused workspace.
+
+    On side×side grids, queries from seeds spread over the grid propagate over the whole grid,
+    with the 8-neighbors Dijkstra and exact fast marching:
+    - algo_run: the functional path, allocating the costs and the front for each query,
+    - fresh: the same buffers, allocated for each query, with the transit inlined,
+    - workspace: the buffers of a workspace, which only forget the costs set by the previous query.
+    The time, the queries per second and the sum of the costs of a fixed point are printed (in TSV).
+
+    Usage: bench_workspace [queries=2000] [max_side=64]
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#include "code.h"
+#include "workspace.h"
+#include "timing.h"
+
+template<typename TC, typename TS>
+void measure(const grid_t & grid, const std::string & transit, unsigned int queries, std::ostream & log, TC & plain, TS & touched)
+{
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+    std::vector<point_t> seeds;
+    for( unsigned int q = 0; q < queries; ++q ) {
+        seeds.push_back(grid.point((q * 7) % grid.width, (q * 13) % grid.height));
+    }
+    const point_t target = grid.point(grid.width/2, grid.height/3);
+    const unsigned int iterations = grid.size();
+
+    auto print = [&] (const std::string & mode, double ms, double sum) {
+        log << transit << "\t" << mode << "\t" << grid.width << "\t" << queries << "\t" << ms
+            << "\t" << queries * 1e3 / ms << "\t" << sum << std::endl;
+    };
+
+    double sum = 0;
+    double ms = chrono_ms([&](){
+        for( const point_t & seed : seeds ) {
+            sum += algo_run(grid, seed, iterations, eight, plain, nullptr, nullptr).at(target);
+        }
+    });
+    print("algo_run", ms, sum);
+
+    sum = 0;
+    ms = chrono_ms([&](){
+        for( const point_t & seed : seeds ) {
+            costs_t costs(grid);
+            front_t front(grid);
+            costs[seed] = 0;
+            front.push(grid.index(seed), 0);
+            algo_propagate(costs, nullptr, front, iterations, eight, plain, nullptr);
+            sum += costs.at(target);
+        }
+    });
+    print("fresh", ms, sum);
+
+    workspace_t<> workspace;
+    sum = 0;
+    ms = chrono_ms([&](){
+        for( const point_t & seed : seeds ) {
+            sum += algo_run(workspace, grid, seed, iterations, eight, touched).at(target);
+        }
+    });
+    print("workspace", ms, sum);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int queries = argc > 1 ? std::stoi(argv[1]) : 2000;
+    unsigned int max_side = argc > 2 ? std::stoi(argv[2]) : 64;
+
+    std::cout << "transit\tmode\tside\tqueries\tms\tqueries_per_s\tsum" << std::endl;
+    for( unsigned int side = 8; side <= max_side; side *= 2 ) {
+        grid_t grid(make_point(0,0), make_point(side-1,side-1), 1);
+        measure(grid, "on_edge", queries, std::cout, transit_on_edge, transit_on_edge_of<double,touched_costs>);
+        measure(grid, "in_simplex_exact", queries, std::cout, transit_in_simplex_exact, transit_in_simplex_exact_of<double,touched_costs>);
+    }
+}
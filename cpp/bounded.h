@@ -0,0 +1,347 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "code.h"
+#include "output.h"
+
+/** \defgroup Bounded Propagation with a memory bounded by the width of the front.
+
+    Behind the front, the costs are final, and are only read by the transits of their adjacent points.
+    The costs are thus stored in square blocks, which are allocated when the front reaches them,
+    and evicted to a sink (e.g. a file) as soon as they, and all the blocks around them, are accepted:
+    no point of the front can then reference them.
+    The memory then holds the blocks along the front, instead of the whole grid,
+    which allows to process grids larger than the memory.
+
+    The neighborhoods should only hold adjacent points (as the quad and octo stencils),
+    and the grid's layout is not used (blocks are addressed by the (i,j) coordinates of the points).
+    Blocks holding points which are never reached (e.g. behind walls) are only evicted at the end.
+
+  @{
+*/
+
+/** A rectangle of costs, given to the sinks. */
+template<typename Real>
+struct costs_tile
+{
+    //! Coordinates of the first point.
+    size_t i;
+    size_t j;
+    //! Number of points along x and y.
+    size_t width;
+    size_t height;
+    //! Distance between the rows in the costs.
+    size_t stride;
+    //! The costs, row after row.
+    const Real* costs;
+
+    Real at(size_t di, size_t dj) const {return costs[dj * stride + di];}
+};
+
+/** Receives the evicted costs. Each point of the grid is given exactly once, in a single tile. */
+template<typename Real>
+using tile_sink = std::function< void(const costs_tile<Real> &) >;
+
+/** Costs stored in blocks, allocated on demand and evicted to a sink once they are no longer referenced.
+
+    Can be given to the transit functions suffixed by _of, instead of a costs_of.
+  */
+template<typename Real = double>
+class paged_costs
+{
+    public:
+        //! \param block_log2 The side of the blocks, as a power of two.
+        paged_costs(const grid_t & grid_, tile_sink<Real> sink, unsigned int block_log2 = 6) :
+            _grid(grid_),
+            _sink(sink),
+            _log2(block_log2),
+            _side(size_t(1) << block_log2),
+            _blocks_x((grid_.width  + _side - 1) >> block_log2),
+            _blocks_y((grid_.height + _side - 1) >> block_log2),
+            _blocks(_blocks_x * _blocks_y),
+            _evicted(_blocks_x * _blocks_y, false),
+            _resident(0),
+            _peak(0)
+        {}
+
+        const grid_t & grid() const {return _grid;}
+        size_t block_side() const {return _side;}
+        size_t blocks() const {return _blocks.size();}
+
+        //! Number of allocated blocks, now and at most.
+        size_t resident() const {return _resident;}
+        size_t peak_resident() const {return _peak;}
+
+        //! Bytes taken by a block (the costs, and a bit per accepted point).
+        size_t block_bytes() const {return _side * _side * sizeof(Real) + _side * _side / 8;}
+
+        //! The cost of a point, infinite if it has not been reached yet. The point should not be evicted.
+        Real at(const point_t & p) const
+        {
+            size_t b = block(p);
+            assert(not _evicted[b]);
+            if( not _blocks[b] ) {
+                return std::numeric_limits<Real>::infinity();
+            }
+            return _blocks[b]->costs[offset(p)];
+        }
+
+        //! The cost of a point, allocating its block if needed.
+        Real& operator[](const point_t & p)
+        {
+            size_t b = block(p);
+            assert(not _evicted[b]);
+            if( not _blocks[b] ) {
+                _blocks[b].reset(new block_t(_side * _side));
+                _resident++;
+                _peak = std::max(_peak, _resident);
+            }
+            return _blocks[b]->costs[offset(p)];
+        }
+
+        //! True if the point has been accepted (which is always the case for evicted points).
+        bool accepted(const point_t & p) const
+        {
+            size_t b = block(p);
+            return _evicted[b] or (_blocks[b] and _blocks[b]->accepted[offset(p)]);
+        }
+
+        /** Mark a reached point as accepted.
+
+            If its block is then complete, the blocks around which are no longer referenced are evicted. */
+        void accept(const point_t & p)
+        {
+            size_t b = block(p);
+            assert(_blocks[b] and not _blocks[b]->accepted[offset(p)]);
+            _blocks[b]->accepted[offset(p)] = true;
+            _blocks[b]->count++;
+            if( complete(b) ) {
+                long bi = static_cast<long>(b % _blocks_x);
+                long bj = static_cast<long>(b / _blocks_x);
+                for( long dj = -1; dj <= 1; ++dj ) {
+                    for( long di = -1; di <= 1; ++di ) {
+                        if( contains(bi+di, bj+dj) ) {
+                            size_t n = (bj+dj) * _blocks_x + (bi+di);
+                            if( evictable(n) ) {
+                                evict(n);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        //! Give all the blocks which have not been evicted yet to the sink (unreached points having an infinite cost).
+        void flush()
+        {
+            std::vector<Real> unreached(_side * _side, std::numeric_limits<Real>::infinity());
+            for( size_t b = 0; b < _blocks.size(); ++b ) {
+                if( not _evicted[b] ) {
+                    sink(b, _blocks[b] ? _blocks[b]->costs.data() : unreached.data());
+                    release(b);
+                }
+            }
+        }
+
+    protected:
+        struct block_t {
+            block_t(size_t cells) : costs(cells, std::numeric_limits<Real>::infinity()), accepted(cells, false), count(0) {}
+            std::vector<Real> costs;
+            std::vector<bool> accepted;
+            size_t count;
+        };
+
+        size_t block(const point_t & p) const
+        {
+            size_t i = static_cast<size_t>(_grid.i(p));
+            size_t j = static_cast<size_t>(_grid.j(p));
+            return (j >> _log2) * _blocks_x + (i >> _log2);
+        }
+
+        size_t offset(const point_t & p) const
+        {
+            size_t i = static_cast<size_t>(_grid.i(p));
+            size_t j = static_cast<size_t>(_grid.j(p));
+            return ((j & (_side-1)) << _log2) + (i & (_side-1));
+        }
+
+        bool contains(long bi, long bj) const
+        {
+            return 0 <= bi and bi < static_cast<long>(_blocks_x) and 0 <= bj and bj < static_cast<long>(_blocks_y);
+        }
+
+        //! Number of points along x and y in a block (the last ones may be truncated by the grid).
+        size_t width (size_t b) const {return std::min(_side, _grid.width  - (b % _blocks_x) * _side);}
+        size_t height(size_t b) const {return std::min(_side, _grid.height - (b / _blocks_x) * _side);}
+
+        //! True if all the points of the block have been accepted.
+        bool complete(size_t b) const
+        {
+            return _evicted[b] or (_blocks[b] and _blocks[b]->count == width(b) * height(b));
+        }
+
+        //! True if the block and all the blocks around are complete.
+        bool evictable(size_t b) const
+        {
+            if( _evicted[b] or not complete(b) ) {
+                return false;
+            }
+            long bi = static_cast<long>(b % _blocks_x);
+            long bj = static_cast<long>(b / _blocks_x);
+            for( long dj = -1; dj <= 1; ++dj ) {
+                for( long di = -1; di <= 1; ++di ) {
+                    if( contains(bi+di, bj+dj) and not complete((bj+dj) * _blocks_x + (bi+di)) ) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        void evict(size_t b)
+        {
+            sink(b, _blocks[b]->costs.data());
+            release(b);
+        }
+
+        void sink(size_t b, const Real* costs) const
+        {
+            costs_tile<Real> tile{(b % _blocks_x) * _side, (b / _blocks_x) * _side, width(b), height(b), _side, costs};
+            _sink(tile);
+        }
+
+        void release(size_t b)
+        {
+            if( _blocks[b] ) {
+                _blocks[b].reset();
+                _resident--;
+            }
+            _evicted[b] = true;
+        }
+
+        const grid_t _grid;
+        tile_sink<Real> _sink;
+        const unsigned int _log2;
+        const size_t _side;
+        const size_t _blocks_x;
+        const size_t _blocks_y;
+        std::vector< std::unique_ptr<block_t> > _blocks;
+        std::vector<bool> _evicted;
+        size_t _resident;
+        size_t _peak;
+};
+
+/** Memory used by a bounded propagation. */
+struct bounded_stats_t
+{
+    size_t accepted = 0;
+    //! Max number of allocated blocks.
+    size_t peak_blocks = 0;
+    //! Max number of entries in the front (including the outdated ones).
+    size_t peak_front = 0;
+    //! Max bytes held by the blocks and the front.
+    size_t peak_bytes = 0;
+};
+
+/** Propagate the front from the given seed over the whole grid, with a memory bounded by the width of the front.
+
+    The costs are given to the sink as soon as they are no longer referenced, and are not kept (see paged_costs).
+    The front is a binary heap in which the points are pushed again when their cost decreases,
+    the outdated entries being skipped when popped, so that it does not hold a position for every point of the grid.
+
+  \param transit A transit function on paged costs (e.g. transit_in_simplex_exact_of<Real,paged_costs>).
+  \param sink Called with each block of final costs.
+  \param block_log2 The side of the blocks, as a power of two.
+*/
+template<typename Real, typename N, typename T>
+bounded_stats_t bounded_run(const grid_t & grid, point_t seed, N & neighbors, T & transit, tile_sink<Real> sink, unsigned int block_log2 = 6)
+{
+    paged_costs<Real> costs(grid, sink, block_log2);
+    bounded_stats_t stats;
+
+    // Points are identified by their row-major index.
+    using entry_t = std::pair<Real,size_t>;
+    std::priority_queue< entry_t, std::vector<entry_t>, std::greater<entry_t> > front;
+    auto key = [&grid] (const point_t & p) {return static_cast<size_t>(grid.j(p)) * grid.width + static_cast<size_t>(grid.i(p));};
+
+    costs[seed] = 0;
+    front.push(entry_t(0, key(seed)));
+    while( not front.empty() ) {
+        stats.peak_front = std::max(stats.peak_front, front.size());
+        stats.peak_bytes = std::max(stats.peak_bytes, costs.resident() * costs.block_bytes() + front.size() * sizeof(entry_t));
+
+        entry_t top = front.top();
+        front.pop();
+        point_t accepted = grid.point(static_cast<long>(top.second % grid.width), static_cast<long>(top.second / grid.width));
+        // Outdated entry.
+        if( costs.accepted(accepted) or top.first > costs.at(accepted) ) {
+            continue;
+        }
+
+        for( auto n : neighbors(accepted) ) {
+            if( not costs.accepted(n) ) {
+                Real c = transit(n, neighbors(n), costs);
+                if( c < costs.at(n) ) {
+                    costs[n] = c;
+                    front.push(entry_t(c, key(n)));
+                }
+            }
+        }
+        // Once its neighbors are updated, the point may be evicted.
+        costs.accept(accepted);
+        stats.accepted++;
+    }
+    costs.flush();
+    stats.peak_blocks = costs.peak_resident();
+    return stats;
+}
+
+/** A sink writing the tiles in a costs file (see the Output group), in row-major order.
+
+    The tiles are written at their place in the file, whatever the order in which they come,
+    so that the file is complete once all the tiles have been given.
+  */
+template<typename Real>
+class tile_file_sink
+{
+    public:
+        tile_file_sink(const grid_t & grid, const std::string & path, costs_format_t format = costs_format_t::npy) :
+            _width(grid.width),
+            _out(std::make_shared<std::ofstream>(path, std::ios::binary | std::ios::trunc))
+        {
+            if( not *_out ) {
+                throw std::runtime_error("cannot open " + path);
+            }
+            std::string header = costs_header<Real>(grid, format);
+            _out->write(header.data(), header.size());
+            _header = header.size();
+        }
+
+        void operator()(const costs_tile<Real> & tile)
+        {
+            for( size_t dj = 0; dj < tile.height; ++dj ) {
+                _out->seekp(static_cast<std::streamoff>(_header + ((tile.j + dj) * _width + tile.i) * sizeof(Real)));
+                _out->write(reinterpret_cast<const char*>(tile.costs + dj * tile.stride), tile.width * sizeof(Real));
+            }
+            if( not *_out ) {
+                throw std::runtime_error("cannot write the costs");
+            }
+        }
+
+    protected:
+        size_t _width;
+        size_t _header;
+        // Shared, since the sinks are copied in std::function.
+        std::shared_ptr<std::ofstream> _out;
+};
+
+/** @} Bounded */
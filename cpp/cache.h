@@ -0,0 +1,201 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "code.h"
+
+/** \defgroup Cache Reuse the costs computed for previous seeds.
+
+    On a uniform domain (i.e. without obstacles nor speed field), the costs from a seed
+    only depend on the offset to the seed: the costs from any other seed are a shifted copy,
+    clipped to the grid. A single canonical field, computed from the center of a grid twice as large,
+    then serves all the seeds, through views offset from its center.
+    The whole grid should then be propagated (the iterations are not limited).
+
+    On other domains, the computed costs are kept in a least recently used cache, per seed.
+
+    Neighborhoods and transits being functions, they are identified by names given by the caller.
+
+  @{
+*/
+
+/** Identification of the way the costs are computed (the grid, the seed and the number of iterations being given apart). */
+struct cache_key_t
+{
+    std::string neighborhood;
+    std::string transit;
+    //! The sampling of the transit, if any (e.g. the eps of transit_in_simplex).
+    double eps;
+};
+
+/** Costs of a grid, read in a field computed on another grid, at an offset. */
+class costs_view
+{
+    public:
+        //! The point (i,j) of the grid is the point (i+di,j+dj) of the field's grid.
+        costs_view(const grid_t & grid_, std::shared_ptr<const costs_t> field, long di, long dj) :
+            _grid(grid_), _field(field), _di(di), _dj(dj)
+        {}
+
+        const grid_t & grid() const {return _grid;}
+
+        double at(long i, long j) const {return _field->at(_field->grid().index(i + _di, j + _dj));}
+        double at(const point_t & p) const {return at(_grid.i(p), _grid.j(p));}
+
+        //! Copy the viewed costs.
+        costs_t costs() const
+        {
+            costs_t costs(_grid);
+            for( long j = 0; j < static_cast<long>(_grid.height); ++j ) {
+                for( long i = 0; i < static_cast<long>(_grid.width); ++i ) {
+                    costs[_grid.index(i,j)] = at(i,j);
+                }
+            }
+            return costs;
+        }
+
+    protected:
+        grid_t _grid;
+        std::shared_ptr<const costs_t> _field;
+        long _di;
+        long _dj;
+};
+
+/** Number of queries served by each part of the cache. */
+struct cache_stats_t
+{
+    size_t queries = 0;
+    //! Served by a view on a canonical field.
+    size_t canonical_hits = 0;
+    //! Served by the least recently used cache.
+    size_t lru_hits = 0;
+    //! Computed.
+    size_t misses = 0;
+
+    double hit_rate() const {return queries == 0 ? 0 : static_cast<double>(canonical_hits + lru_hits) / queries;}
+};
+
+/** A cache of costs fields. */
+class costs_cache
+{
+    public:
+        using neighbors_f = std::function< neighbors_t(const point_t&) >;
+        using transit_f = std::function< double(const point_t &, const neighbors_t &, const costs_t &) >;
+
+        //! \param capacity The number of costs fields kept for non-uniform domains (none if zero).
+        costs_cache(size_t capacity = 16) : _capacity(capacity) {}
+
+        /** The costs from the seed, on a uniform domain, propagated over the whole grid.
+
+            \tparam Stencil The neighborhood (see neighbors_grid), applied on the canonical grid.
+          */
+        template<typename Stencil>
+        costs_view uniform(const cache_key_t & key, const grid_t & grid, point_t seed, transit_f transit)
+        {
+            _stats.queries++;
+            canonical_key_t k(key.neighborhood, key.transit, key.eps, grid.step);
+            auto found = _canonical.find(k);
+            // A field at least as large as twice the grid.
+            if( found == _canonical.end() or found->second.half_width < grid.width or found->second.half_height < grid.height ) {
+                _stats.misses++;
+                // Large enough for the previous grids too, so that grids of other shapes do not replace each other.
+                size_t half_width = grid.width;
+                size_t half_height = grid.height;
+                if( found != _canonical.end() ) {
+                    half_width = std::max(half_width, found->second.half_width);
+                    half_height = std::max(half_height, found->second.half_height);
+                }
+                // Only the offsets to the center matter: it is put on the grid's origin.
+                grid_t canonical(
+                    make_point(x(grid.pmin) - (half_width-1) * grid.step, y(grid.pmin) - (half_height-1) * grid.step),
+                    make_point(x(grid.pmin) + (half_width-1) * grid.step, y(grid.pmin) + (half_height-1) * grid.step), grid.step);
+                auto around = [&canonical](const point_t& p) {return neighbors_grid<Stencil>(p,canonical);};
+                std::shared_ptr<costs_t> field = std::make_shared<costs_t>(canonical);
+                front_t front(canonical);
+                point_t center = canonical.point(static_cast<long>(half_width-1), static_cast<long>(half_height-1));
+                (*field)[center] = 0;
+                front.push(canonical.index(center), 0);
+                algo_propagate(*field, nullptr, front, canonical.size(), around, transit, nullptr);
+                _canonical[k] = canonical_t{field, half_width, half_height};
+                found = _canonical.find(k);
+            } else {
+                _stats.canonical_hits++;
+            }
+            const canonical_t & c = found->second;
+            return costs_view(grid, c.field, static_cast<long>(c.half_width-1) - grid.i(seed), static_cast<long>(c.half_height-1) - grid.j(seed));
+        }
+
+        /** The costs from the seed, on any domain, from the least recently used cache, or computed.
+
+            The neighbors should not change while the grid stays the same. */
+        costs_view any(const cache_key_t & key, const grid_t & grid, point_t seed, unsigned int iterations, neighbors_f neighbors, transit_f transit)
+        {
+            _stats.queries++;
+            std::shared_ptr<const costs_t> field;
+            lru_key_t k(key.neighborhood, key.transit, key.eps, grid.step, iterations,
+                        x(grid.pmin), y(grid.pmin), grid.width, grid.height, grid.i(seed), grid.j(seed));
+            auto found = _index.find(k);
+            if( found != _index.end() ) {
+                _stats.lru_hits++;
+                // Most recently used first.
+                _lru.splice(_lru.begin(), _lru, found->second);
+                field = _lru.front().second;
+            } else {
+                _stats.misses++;
+                std::shared_ptr<costs_t> computed = std::make_shared<costs_t>(grid);
+                front_t front(grid);
+                (*computed)[seed] = 0;
+                front.push(grid.index(seed), 0);
+                algo_propagate(*computed, nullptr, front, iterations, neighbors, transit, nullptr);
+                field = computed;
+                _lru.push_front(std::make_pair(k, computed));
+                _index[k] = _lru.begin();
+                // May evict the field just computed (without capacity), which is still returned.
+                if( _lru.size() > _capacity ) {
+                    _index.erase(_lru.back().first);
+                    _lru.pop_back();
+                }
+            }
+            return costs_view(grid, field, 0, 0);
+        }
+
+        const cache_stats_t & stats() const {return _stats;}
+
+        //! Number of fields held, canonical or not.
+        size_t size() const {return _canonical.size() + _lru.size();}
+
+        //! Remove all the fields (but not the stats).
+        void clear()
+        {
+            _canonical.clear();
+            _lru.clear();
+            _index.clear();
+        }
+
+    protected:
+        using canonical_key_t = std::tuple<std::string, std::string, double, double>;
+        //! A field computed from the center of a grid of (2*half_width-1)*(2*half_height-1) points.
+        struct canonical_t
+        {
+            std::shared_ptr<const costs_t> field;
+            size_t half_width;
+            size_t half_height;
+        };
+        using lru_key_t = std::tuple<std::string, std::string, double, double, unsigned int, double, double, size_t, size_t, long, long>;
+        using lru_t = std::list< std::pair< lru_key_t, std::shared_ptr<const costs_t> > >;
+
+        size_t _capacity;
+        std::map<canonical_key_t, canonical_t> _canonical;
+        lru_t _lru;
+        std::map<lru_key_t, lru_t::iterator> _index;
+        cache_stats_t _stats;
+};
+
+/** @} Cache */
@@ -1,18 +1,58 @@
+#pragma once
+
 #include <iterator>
+#include <algorithm>
+#include <limits>
 #include <utility>
 #include <iomanip>
+#include <iostream>
+#include <string>
+#include <queue>
+#include <ratio>
 #include <functional>
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#ifdef ALGOPATTERN_STATS
+#include <chrono>
+#endif
 
 //! x, y.
 using point_t = std::pair<double,double>;
-//! Time to go to a given point.
-using costs_t = std::map<point_t,double>;
-//! Concept to compare points.
-using comp_t = std::function< bool( const point_t lhs, const point_t rhs) >;
-//! The priority queue that permits an efficient single pass over the domain.
-using front_t = std::priority_queue<point_t,std::vector<point_t>,comp_t>;
-//! Set of points "around".
-using neighbors_t = std::vector<point_t>;
+//! Integer displacement on a grid, in number of steps along x and y.
+using offset_t = std::pair<int,int>;
+
+/** A sequence of at most N items, stored inline (i.e. without any heap allocation). */
+template<typename T, size_t N>
+class inline_vector
+{
+    public:
+        inline_vector() : _size(0) {}
+
+        static constexpr size_t capacity() {return N;}
+        size_t size() const {return _size;}
+        bool  empty() const {return _size == 0;}
+        void  clear()       {_size = 0;}
+
+        void push_back(const T & item)
+        {
+            assert(_size < N);
+            _items[_size++] = item;
+        }
+
+        T&       operator[](size_t i)       {assert(i < _size); return _items[i];}
+        const T& operator[](size_t i) const {assert(i < _size); return _items[i];}
+
+        T*       begin()       {return _items;}
+        T*       end  ()       {return _items + _size;}
+        const T* begin() const {return _items;}
+        const T* end  () const {return _items + _size;}
+
+    protected:
+        T _items[N];
+        size_t _size;
+};
 
 point_t make_point(double x, double y) {return std::make_pair(x,y);}
 double& x(      point_t& p) {return p.first ;}
@@ -22,16 +62,610 @@ double  y(const point_t& p) {return p.second;}
 //! Euclidean distance.
 double distance(point_t u, point_t v) {return sqrt( (x(u)-x(v))*(x(u)-x(v)) + (y(u)-y(v))*(y(u)-y(v)) );}
 
+
+/** Order in which the points of a grid are stored.
+
+    - row_major: row after row, x first.
+    - tiled: square tiles of 2^tile_log2 points of side, stored row after row,
+      each tile being stored contiguously, row after row.
+    - morton: same tiles, each one stored in Z-order (i.e. the bits of x and y are interleaved).
+      The tiles are bounded (32 points of side by default), so that the padding stays
+      small on elongated grids, which a single power-of-two square would multiply.
+
+    The tiled layouts keep the neighbors of a point close in memory in both directions,
+    instead of one row apart, which matters for the (roughly circular) fronts on grids larger than the caches.
+    The last tiles are padded, so that the storage may be larger than the number of points.
+  */
+enum class layout_t { row_major, tiled, morton };
+
+/** Spread the lower 32 bits of v on the even bits of the result. */
+inline uint64_t morton_spread(uint64_t v)
+{
+    v &= 0xffffffff;
+    v = (v | (v << 16)) & 0x0000ffff0000ffff;
+    v = (v | (v <<  8)) & 0x00ff00ff00ff00ff;
+    v = (v | (v <<  4)) & 0x0f0f0f0f0f0f0f0f;
+    v = (v | (v <<  2)) & 0x3333333333333333;
+    v = (v | (v <<  1)) & 0x5555555555555555;
+    return v;
+}
+
+/** Gather the even bits of v in the lower bits of the result. */
+inline uint64_t morton_compact(uint64_t v)
+{
+    v &= 0x5555555555555555;
+    v = (v | (v >>  1)) & 0x3333333333333333;
+    v = (v | (v >>  2)) & 0x0f0f0f0f0f0f0f0f;
+    v = (v | (v >>  4)) & 0x00ff00ff00ff00ff;
+    v = (v | (v >>  8)) & 0x0000ffff0000ffff;
+    v = (v | (v >> 16)) & 0x00000000ffffffff;
+    return v;
+}
+
+/** A regular square grid, defined by a rectangle and an orthogonal step size.
+
+    Points of the grid are addressed by integer coordinates (i along x, j along y),
+    or by a flat index in a dense storage, ordered according to the grid's layout (see layout_t).
+    Coordinates of points are always recomputed from (i,j),
+    so that no floating-point error accumulates when walking across the grid.
+  */
+class grid_t
+{
+    public:
+        /** \param layout_ The storage order of the points.
+            \param tile_log2_ The side of the tiles of the tiled layouts, as a power of two
+                              (if zero: 16 points for tiled, and 32 for morton). */
+        grid_t(const point_t & pmin_, const point_t & pmax_, double step_, layout_t layout_ = layout_t::row_major, unsigned int tile_log2_ = 0)
+            : pmin(pmin_), pmax(pmax_), step(step_),
+              // The small tolerance avoids losing the last line
+              // if the extent is not an exact multiple of the step.
+              width ( static_cast<size_t>(std::floor((x(pmax)-x(pmin)) / step + 1e-6)) + 1 ),
+              height( static_cast<size_t>(std::floor((y(pmax)-y(pmin)) / step + 1e-6)) + 1 ),
+              layout(layout_), tile_log2(tile_log2_)
+        {
+            assert(step > 0);
+            assert(x(pmin) <= x(pmax) and y(pmin) <= y(pmax));
+            if( layout == layout_t::row_major ) {
+                tile_log2 = 0;
+                _tiles_x = width;
+                _storage = width * height;
+            } else {
+                if( tile_log2 == 0 ) {
+                    tile_log2 = layout == layout_t::tiled ? 4 : 5;
+                }
+                assert(tile_log2 < 32);
+                size_t side = size_t(1) << tile_log2;
+                _tiles_x = (width + side - 1) >> tile_log2;
+                _storage = _tiles_x * ((height + side - 1) >> tile_log2) << (2*tile_log2);
+            }
+        }
+
+        //! Number of points in the storage (which includes the padding of the tiled layouts).
+        size_t size() const {return _storage;}
+
+        //! Integer coordinates of the grid point nearest to p.
+        long i(const point_t & p) const {return std::lround( (x(p)-x(pmin)) / step );}
+        long j(const point_t & p) const {return std::lround( (y(p)-y(pmin)) / step );}
+
+        bool contains(long i, long j) const
+        {
+            return 0 <= i and i < static_cast<long>(width) and 0 <= j and j < static_cast<long>(height);
+        }
+
+        //! Flat index of the grid point (i,j).
+        size_t index(long i, long j) const
+        {
+            assert(contains(i,j));
+            if( layout == layout_t::row_major ) {
+                return static_cast<size_t>(j) * width + static_cast<size_t>(i);
+            }
+            const size_t mask = (size_t(1) << tile_log2) - 1;
+            const size_t ti = static_cast<size_t>(i), tj = static_cast<size_t>(j);
+            size_t tile = ((tj >> tile_log2) * _tiles_x + (ti >> tile_log2)) << (2*tile_log2);
+            if( layout == layout_t::tiled ) {
+                return tile + (((tj & mask) << tile_log2) | (ti & mask));
+            } else {
+                return tile + (morton_spread(ti & mask) | (morton_spread(tj & mask) << 1));
+            }
+        }
+        size_t index(const point_t & p) const {return index(i(p),j(p));}
+
+        //! Integer coordinates (i,j) of the point at the given flat index (which may be in the padding).
+        std::pair<long,long> coords(size_t idx) const
+        {
+            if( layout == layout_t::row_major ) {
+                return std::make_pair(static_cast<long>(idx % width), static_cast<long>(idx / width));
+            }
+            const size_t mask = (size_t(1) << (2*tile_log2)) - 1;
+            size_t tile = idx >> (2*tile_log2);
+            size_t in = idx & mask;
+            size_t ii, jj;
+            if( layout == layout_t::tiled ) {
+                ii = in & ((size_t(1) << tile_log2) - 1);
+                jj = in >> tile_log2;
+            } else {
+                ii = morton_compact(in);
+                jj = morton_compact(in >> 1);
+            }
+            return std::make_pair( static_cast<long>(((tile % _tiles_x) << tile_log2) + ii),
+                                   static_cast<long>(((tile / _tiles_x) << tile_log2) + jj) );
+        }
+
+        //! Index of the point at the given flat index, in the row-major order (e.g. of a raster).
+        size_t row_major(size_t idx) const
+        {
+            if( layout == layout_t::row_major ) {
+                return idx;
+            }
+            std::pair<long,long> c = coords(idx);
+            return static_cast<size_t>(c.second) * width + static_cast<size_t>(c.first);
+        }
+
+        //! Coordinates of the grid point (i,j).
+        point_t point(long i, long j) const {return make_point(x(pmin) + i*step, y(pmin) + j*step);}
+        point_t point(size_t idx) const {std::pair<long,long> c = coords(idx); return point(c.first, c.second);}
+
+        point_t pmin;
+        point_t pmax;
+        double step;
+        size_t width;
+        size_t height;
+        layout_t layout;
+        unsigned int tile_log2;
+
+        //! True if the points have the same flat index on both grids.
+        bool same_index(const grid_t & other) const
+        {
+            return pmin == other.pmin and step == other.step and width == other.width and height == other.height
+               and layout == other.layout and tile_log2 == other.tile_log2;
+        }
+
+    protected:
+        //! Number of tiles along x (of the grid's width, for row_major).
+        size_t _tiles_x;
+        size_t _storage;
+};
+
+/** Set of points "around", at most the eight adjacent points of a square grid.
+
+    The neighbors computed on a grid (see neighbors_grid_if) also hold their flat index on it,
+    so that their costs are looked up without computing it again (see neighbors_costs).
+  */
+class neighbors_t : public inline_vector<point_t,8>
+{
+    public:
+        neighbors_t() : _grid(nullptr) {}
+        //! Neighbors on the given grid, which should outlive them.
+        explicit neighbors_t(const grid_t & grid) : _grid(&grid) {}
+
+        //! Add a point, whose index is computed if the neighbors are on a grid.
+        void push_back(const point_t & p) {push_back(p, _grid ? _grid->index(p) : 0);}
+        //! Add a point of the grid of the neighbors, along with its index.
+        void push_back(const point_t & p, size_t idx)
+        {
+            assert(size() < capacity());
+            _index[size()] = idx;
+            inline_vector<point_t,8>::push_back(p);
+        }
+
+        //! Flat index of the i-th neighbor, if they are on a grid.
+        size_t index(size_t i) const {assert(_grid and i < size()); return _index[i];}
+
+        //! True if the neighbors are on a grid indexing the points as the given one.
+        bool indexed_on(const grid_t & grid) const {return _grid and (_grid == &grid or _grid->same_index(grid));}
+
+    protected:
+        const grid_t * _grid;
+        size_t _index[8];
+};
+
+//! For the unqualified calls (e.g. std::any_of(begin(neighbors), end(neighbors), ...)).
+inline       point_t* begin(      neighbors_t & neighbors) {return neighbors.begin();}
+inline       point_t* end  (      neighbors_t & neighbors) {return neighbors.end();}
+inline const point_t* begin(const neighbors_t & neighbors) {return neighbors.begin();}
+inline const point_t* end  (const neighbors_t & neighbors) {return neighbors.end();}
+
+
+/** Time to go to each point of a grid.
+
+    Costs are stored densely, in a contiguous array addressed by the flat index of the points.
+    A point without cost (yet) holds an infinite cost.
+
+    Costs are Real numbers: in single precision (float), they take half the memory (and bandwidth)
+    of the double precision ones, at the expense of the last digits (see costs_deviation).
+  */
+template<typename Real>
+class costs_of
+{
+    public:
+        using real_t = Real;
+
+        costs_of(const grid_t & grid_) : _grid(grid_), _costs(grid_.size(), std::numeric_limits<Real>::infinity()) {}
+
+        const grid_t & grid() const {return _grid;}
+        size_t size() const {return _costs.size();}
+
+        //! Remove all the costs.
+        void reset() {std::fill(begin(_costs), end(_costs), std::numeric_limits<Real>::infinity());}
+
+        Real& operator[](size_t idx)       {assert(idx < _costs.size()); return _costs[idx];}
+        Real  at        (size_t idx) const {assert(idx < _costs.size()); return _costs[idx];}
+
+        Real& operator[](const point_t & p)       {return _costs[_grid.index(p)];}
+        Real  at        (const point_t & p) const {return _costs[_grid.index(p)];}
+
+        //! The contiguous costs, in the grid's index order.
+        const Real* data() const {return _costs.data();}
+
+    protected:
+        grid_t _grid;
+        std::vector<Real> _costs;
+};
+
+//! Costs in double precision, used everywhere unless stated otherwise.
+using costs_t = costs_of<double>;
+
+/** True if the costs can be looked up by the indices of the neighbors (see neighbors_t::index).
+
+    Only for the costs stores indexed as a grid_t, and only if it is the grid of the neighbors. */
+template<typename Real, template<typename> class Costs>
+bool neighbors_indexed(const neighbors_t &, const Costs<Real> &) {return false;}
+
+template<typename Real>
+bool neighbors_indexed(const neighbors_t & neighbors, const costs_of<Real> & costs) {return neighbors.indexed_on(costs.grid());}
+
+/** Gather the costs of the neighbors, in their order, by their indices if possible (see neighbors_indexed). */
+template<typename Real, template<typename> class Costs>
+void neighbors_costs(const neighbors_t & neighbors, const Costs<Real> & costs, Real * dest)
+{
+    for( size_t k = 0; k < neighbors.size(); ++k ) {
+        dest[k] = costs.at(neighbors[k]);
+    }
+}
+
+template<typename Real>
+void neighbors_costs(const neighbors_t & neighbors, const costs_of<Real> & costs, Real * dest)
+{
+    if( neighbors.indexed_on(costs.grid()) ) {
+        for( size_t k = 0; k < neighbors.size(); ++k ) {
+            dest[k] = costs.at(neighbors.index(k));
+        }
+    } else {
+        for( size_t k = 0; k < neighbors.size(); ++k ) {
+            dest[k] = costs.at(neighbors[k]);
+        }
+    }
+}
+
+/** Deviation of costs computed in a lower precision from reference ones (computed in double precision). */
+struct deviation_t
+{
+    //! Max absolute difference, among the points reached in both.
+    double max_abs = 0;
+    //! Max difference relative to the reference cost, among the points reached in both.
+    double max_rel = 0;
+    //! Index of the point having the max absolute difference.
+    size_t worst = 0;
+    //! Number of points reached in only one of them.
+    size_t unmatched = 0;
+};
+
+/** Compare the costs with reference ones, computed on the same grid. */
+template<typename Real>
+deviation_t costs_deviation(const costs_of<Real> & costs, const costs_t & reference)
+{
+    assert(costs.size() == reference.size());
+    deviation_t deviation;
+    for( size_t idx = 0; idx < costs.size(); ++idx ) {
+        double c = costs.at(idx);
+        double r = reference.at(idx);
+        if( std::isinf(c) or std::isinf(r) ) {
+            deviation.unmatched += std::isinf(c) != std::isinf(r);
+            continue;
+        }
+        double diff = std::abs(c - r);
+        if( diff > deviation.max_abs ) {
+            deviation.max_abs = diff;
+            deviation.worst = idx;
+        }
+        if( r > 0 ) {
+            deviation.max_rel = std::max(deviation.max_rel, diff / r);
+        }
+    }
+    return deviation;
+}
+
+
+/** The priority queue that permits an efficient single pass over the domain.
+
+    A D-ary heap holding the nodes indices along with their costs,
+    so that comparisons do not need to look into the costs grid.
+    An index of the position of each node in the heap allows
+    to decrease the cost of a node which is already in the front.
+  */
+template<unsigned int D>
+class heap_front
+{
+    public:
+        //! Position of the nodes which are not in the front.
+        static const size_t npos = std::numeric_limits<size_t>::max();
+
+        //! \param nodes The number of nodes that may enter the front.
+        heap_front(size_t nodes) : _position(nodes, npos) {}
+        heap_front(const grid_t & grid) : heap_front(grid.size()) {}
+
+        bool   empty() const {return _heap.empty();}
+        size_t size () const {return _heap.size();}
+
+        //! True if the given node is currently in the front.
+        bool contains(size_t idx) const {return _position[idx] != npos;}
+
+        //! Node with the minimal cost.
+        size_t top() const {assert(not empty()); return _heap.front().index;}
+
+        void push(size_t idx, double cost)
+        {
+            assert(not contains(idx));
+            _heap.push_back({cost, idx});
+            sift_up(_heap.size()-1);
+        }
+
+        /** Decrease the cost of a node in the front, or push it if it is not in the front. */
+        void update(size_t idx, double cost)
+        {
+            if( not contains(idx) ) {
+                push(idx, cost);
+            } else {
+                size_t pos = _position[idx];
+                assert(cost <= _heap[pos].cost);
+                _heap[pos].cost = cost;
+                sift_up(pos);
+            }
+        }
+
+        //! Remove all the nodes, in a time proportional to their number.
+        void clear()
+        {
+            for( const node & n : _heap ) {
+                _position[n.index] = npos;
+            }
+            _heap.clear();
+        }
+
+        //! Remove the node with the minimal cost and return its index.
+        size_t pop()
+        {
+            assert(not empty());
+            size_t idx = _heap.front().index;
+            _position[idx] = npos;
+            node last = _heap.back();
+            _heap.pop_back();
+            if( not _heap.empty() ) {
+                _heap.front() = last;
+                sift_down(0);
+            }
+            return idx;
+        }
+
+    protected:
+        struct node {
+            double cost;
+            size_t index;
+        };
+        std::vector<node> _heap;
+        std::vector<size_t> _position;
+
+        void place(size_t pos, const node & n)
+        {
+            _heap[pos] = n;
+            _position[n.index] = pos;
+        }
+
+        void sift_up(size_t pos)
+        {
+            node n = _heap[pos];
+            while( pos > 0 ) {
+                size_t parent = (pos-1) / D;
+                if( _heap[parent].cost <= n.cost ) {
+                    break;
+                }
+                place(pos, _heap[parent]);
+                pos = parent;
+            }
+            place(pos, n);
+        }
+
+        void sift_down(size_t pos)
+        {
+            node n = _heap[pos];
+            while( true ) {
+                size_t first = D*pos + 1;
+                if( first >= _heap.size() ) {
+                    break;
+                }
+                size_t last = std::min(first + D, _heap.size());
+                size_t child = first;
+                for( size_t c = first+1; c < last; ++c ) {
+                    if( _heap[c].cost < _heap[child].cost ) {
+                        child = c;
+                    }
+                }
+                if( n.cost <= _heap[child].cost ) {
+                    break;
+                }
+                place(pos, _heap[child]);
+                pos = child;
+            }
+            place(pos, n);
+        }
+};
+template<unsigned int D>
+const size_t heap_front<D>::npos;
+
+//! The default front: a 4-ary heap, which makes for shallower trees than a binary one.
+using front_t = heap_front<4>;
+
+/** A bucketed front, popping nodes in an approximate order in (amortized) constant time.
+
+    Nodes are sorted in buckets of costs of width WIDTH * grid_step,
+    held in a circular array which grows if the front spans more buckets.
+    Nodes in the same bucket are popped in an arbitrary order,
+    and a decreased cost moves the node in a lower bucket,
+    leaving a stale entry which is skipped when reached.
+
+    If the bucket width is lower than the smallest transit cost between two nodes,
+    the order in which nodes are accepted is exact (this is Dial's algorithm).
+    For instance, with transit_on_edge and WIDTH=1, since all edges are at least grid_step long.
+    Otherwise, this is the "untidy" priority queue of Yatziv et al. (2006):
+    a node can be accepted before another one having a lower cost of at most the bucket width,
+    which adds an error of the order of WIDTH * grid_step on the computed costs,
+    i.e. of the same order as the discretization error of the fast marching.
+  */
+template<typename WIDTH = std::ratio<1>>
+class bucket_front
+{
+    public:
+        //! Key of the nodes which are not in the front.
+        static const size_t npos = std::numeric_limits<size_t>::max();
+
+        bucket_front(const grid_t & grid)
+            : _width( grid.step * static_cast<double>(WIDTH::num) / static_cast<double>(WIDTH::den) ),
+              _key(grid.size(), npos), _buckets(16), _first(0), _size(0)
+        {
+            assert(_width > 0);
+        }
+
+        bool   empty() const {return _size == 0;}
+        size_t size () const {return _size;}
+
+        //! True if the given node is currently in the front.
+        bool contains(size_t idx) const {return _key[idx] != npos;}
+
+        //! A node within the bucket of minimal costs.
+        size_t top() const {assert(not empty()); return bucket(_first).back();}
+
+        void push(size_t idx, double cost)
+        {
+            assert(not contains(idx));
+            if( empty() ) {
+                _first = key(cost);
+            }
+            insert(idx, key(cost));
+            _size++;
+            settle();
+        }
+
+        /** Decrease the cost of a node in the front, or push it if it is not in the front. */
+        void update(size_t idx, double cost)
+        {
+            if( not contains(idx) ) {
+                push(idx, cost);
+            } else if( key(cost) < _key[idx] ) {
+                insert(idx, key(cost));
+                settle();
+            }
+        }
+
+        //! Remove all the nodes, in a time proportional to their number of entries.
+        void clear()
+        {
+            for( std::vector<size_t> & b : _buckets ) {
+                for( size_t idx : b ) {
+                    _key[idx] = npos;
+                }
+                b.clear();
+            }
+            _first = 0;
+            _size = 0;
+        }
+
+        //! Remove a node of the bucket of minimal costs and return its index.
+        size_t pop()
+        {
+            size_t idx = top();
+            bucket(_first).pop_back();
+            _key[idx] = npos;
+            _size--;
+            settle();
+            return idx;
+        }
+
+    protected:
+        const double _width;
+        //! Key of the bucket holding the valid entry of each node.
+        std::vector<size_t> _key;
+        //! Circular array of buckets.
+        std::vector< std::vector<size_t> > _buckets;
+        //! Key of the first non-empty bucket.
+        size_t _first;
+        size_t _size;
+
+        size_t key(double cost) const {return static_cast<size_t>(cost / _width);}
+
+        std::vector<size_t> & bucket(size_t k)       {return _buckets[k % _buckets.size()];}
+        const std::vector<size_t> & bucket(size_t k) const {return _buckets[k % _buckets.size()];}
+
+        void insert(size_t idx, size_t k)
+        {
+            // A cost lower than the current minimal bucket is accepted next anyway.
+            k = std::max(k, _first);
+            if( k - _first >= _buckets.size() ) {
+                grow(k - _first + 1);
+            }
+            bucket(k).push_back(idx);
+            _key[idx] = k;
+        }
+
+        //! Make the circular array large enough to hold the given number of buckets.
+        void grow(size_t span)
+        {
+            size_t n = _buckets.size();
+            while( n < span ) {
+                n *= 2;
+            }
+            std::vector< std::vector<size_t> > buckets(n);
+            for( size_t k = _first; k < _first + _buckets.size(); ++k ) {
+                for( size_t idx : bucket(k) ) {
+                    // Stale entries are dropped.
+                    if( _key[idx] == k ) {
+                        buckets[k % n].push_back(idx);
+                    }
+                }
+            }
+            _buckets.swap(buckets);
+        }
+
+        //! Move to the first valid entry, removing stale ones.
+        void settle()
+        {
+            if( empty() ) {
+                return;
+            }
+            while( true ) {
+                std::vector<size_t> & b = bucket(_first);
+                while( not b.empty() and _key[b.back()] != _first ) {
+                    b.pop_back();
+                }
+                if( not b.empty() ) {
+                    break;
+                }
+                _first++;
+            }
+        }
+};
+template<typename WIDTH>
+const size_t bucket_front<WIDTH>::npos;
+
 /** Test if a cost has already been computed for a given point.
 
     \param p     The considered point.
-    \param costs The costs map in which to look for the given point.
+    \param costs The costs grid in which to look for the given point (costs_of, or any store having at(p)).
   */
-bool has_cost(point_t p, const costs_t & costs)
+template<typename Real, template<typename> class Costs>
+bool has_cost(point_t p, const Costs<Real> & costs)
 {
-    // The map does not have the point as key,
-    // or it have an infinite cost (not use at the moment).
-    return costs.find(p) != costs.end() and costs.at(p) < std::numeric_limits<double>::infinity();
+    // Points without a computed cost have an infinite one.
+    return costs.at(p) < std::numeric_limits<Real>::infinity();
 }
 
 
@@ -125,111 +759,201 @@ auto make_tour(C& c) -> tour<decltype(begin(c))>
 /** \defgroup Algorithm The actual code necessary for all Dijkstra/Fast Marching variants.
 
     The algorithms operates on an IMPLICIT square grid defined by a rectangle and an orthogonal step size.
-    They propagate a front of computed isotropic costs (stored in a [sparse] map), from a single seed.
+    They propagate a front of computed isotropic costs (stored in a dense grid), from a single seed.
 
   @{
 */
 
+/** Directions toward the neighbors on a grid, as compile-time integer displacements.
+
+    Displacements are given as flatten (x,y) pairs, in a specific order
+    (in this project, the transit_in_simplex functions will necessitate clockwise order).
+ */
+template<int... XY>
+struct stencil
+{
+    static_assert(sizeof...(XY) % 2 == 0, "displacements should be given as (x,y) pairs");
+    static constexpr size_t size = sizeof...(XY) / 2;
+    static constexpr int xy[sizeof...(XY)] = {XY...};
+};
+template<int... XY>
+constexpr size_t stencil<XY...>::size;
+template<int... XY>
+constexpr int stencil<XY...>::xy[sizeof...(XY)];
+
+//! The four closest orthogonal neighbors, in clockwise order.
+using quad_stencil = stencil< 1,0, 0,-1, -1,0, 0,1 >;
+//! The four orthogonal neighbors and the four diagonal ones, in clockwise order.
+using octo_stencil = stencil< 1,0, 1,-1, 0,-1, -1,-1, -1,0, -1,1, 0,1, 1,1 >;
+
+/** Compute coordinates of the neighbors of the given point, on a grid with impassable points.
+
+  Same as neighbors_grid, for the points for which passable(index) is true.
+  The impassable points (e.g. obstacles) have no neighbors: their transit is infinite,
+  and they are thus never reached. They stay among the neighbors of the other points,
+  without cost, so that the transits in simplexes only join neighbors adjacent in the stencil
+  (removing them would join neighbors across an obstacle, or across the point itself).
+
+  \tparam Stencil The integer displacements toward the neighbors.
+  \param p The considered point.
+  \param grid The grid on which the neighbors are searched.
+  \param passable A predicate on the index of the points in the grid.
+  \return A sequence of neighbors points, empty if p is impassable.
+ */
+template<typename Stencil, typename Passable>
+inline neighbors_t neighbors_grid_if(const point_t & p, const grid_t & grid, Passable passable)
+{
+    static_assert(Stencil::size <= neighbors_t::capacity(), "the stencil does not fit in neighbors_t");
+    neighbors_t neighbors(grid);
+    const long i = grid.i(p);
+    const long j = grid.j(p);
+    if( not passable(grid.index(i,j)) ) {
+        return neighbors;
+    }
+    for( size_t d = 0; d < Stencil::size; ++d) {
+        long ni = i + Stencil::xy[2*d];
+        long nj = j + Stencil::xy[2*d+1];
+        if( grid.contains(ni,nj) ) {
+            neighbors.push_back( grid.point(ni,nj), grid.index(ni,nj) );
+        }
+    }
+    return neighbors;
+}
+
 /** Compute coordinates of the neighbors of the given point, according to grid parameters and directions.
 
   Directions are supposed to be given in a specific order
   (in this project, the transit_in_simplex functions will necessitate clockwise order).
 
+  \tparam Stencil The integer displacements toward the neighbors.
   \param p The considered point.
-  \param grid_step Length of an orthogonal edge of the grid.
-  \param pmin Corner point of the grid, with minimal coordinates.
-  \param pmax Corner point of the grid, with maximal coordinates.
+  \param grid The grid on which the neighbors are searched.
   \return A sequence of neighbors points.
  */
-inline neighbors_t neighbors_grid(const point_t & p, double grid_step, const point_t & pmin, const point_t & pmax, std::vector<point_t> directions)
+template<typename Stencil>
+inline neighbors_t neighbors_grid(const point_t & p, const grid_t & grid)
 {
-    neighbors_t neighbors;
-    for( point_t d : directions) {
-        point_t n;
-        x(n) = x(p) + x(d) * grid_step;
-        y(n) = y(p) + y(d) * grid_step;
-        if( x(pmin) <= x(n) and x(n) <= x(pmax) and y(pmin) <= y(n) and y(n) <= y(pmax) ) {
-            neighbors.push_back( n );
-        }
-    }
+    neighbors_t neighbors = neighbors_grid_if<Stencil>(p, grid, [](size_t){return true;});
     assert(neighbors.size() >= 2);
     return neighbors;
 }
 
-/** Find the transit of minimal cost among the given edges.
+/* The transits are computed in the Real type of the costs (the functions suffixed by _of).
+   The coordinates of the points stay in double precision (they are recomputed from the grid),
+   only their differences are converted to Real.
+   The functions without suffix are the double precision ones,
+   which can be given where a (non-template) transit function is expected.
+   Any costs store giving the cost of a point with at(p) can be used instead of costs_of (see paged_costs).
+   The costs of the neighbors are gathered once per transit (see neighbors_costs),
+   by their indices if the neighbors have been computed on the grid of the costs. */
 
-    Edges are given as the considered point and the sequence of neighbors points. */
-inline double transit_on_edge(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
+/** Find the transit of minimal cost among the given edges, at the given slowness.
+
+    Edges are given as the considered point and the sequence of neighbors points.
+    The slowness (the inverse of the speed) around p scales the distances. */
+template<typename Real, template<typename> class Costs = costs_of>
+inline Real transit_on_edge_weighted_of(const point_t & p, const neighbors_t & neighbors, const Costs<Real> & costs, double slowness)
 {
-    double mincost = std::numeric_limits<double>::infinity();
-    for( auto n : neighbors ) {
+    const Real s = static_cast<Real>(slowness);
+    const Real inf = std::numeric_limits<Real>::infinity();
+    Real mincost = inf;
+    Real around[neighbors_t::capacity()];
+    neighbors_costs(neighbors, costs, around);
+    for( size_t k = 0; k < neighbors.size(); ++k ) {
         // Do not compute transition toward points without a cost
         // (i.e. Supposedly, only toward the front).
-        if( has_cost(n, costs) ) {
+        if( around[k] < inf ) {
             // Cost of the transition from/to p from/to n.
-            double c = costs.at(n) + distance(p, n);
+            Real c = around[k] + s * static_cast<Real>(distance(p, neighbors[k]));
             if( c < mincost ) {
                 mincost = c;
             }
         }
     }
-    // Should be near the front (and thus have found a transit).
-    assert(mincost != std::numeric_limits<double>::infinity());
+    // Should be near the front (and thus have found a transit), unless p is impassable (see neighbors_grid_if).
+    assert(neighbors.empty() or mincost != std::numeric_limits<Real>::infinity());
     return mincost;
 }
 
+inline double transit_on_edge_weighted(const point_t & p, const neighbors_t & neighbors, const costs_t & costs, double slowness)
+{
+    return transit_on_edge_weighted_of(p, neighbors, costs, slowness);
+}
+
+/** Find the transit of minimal cost among the given edges, at unit speed. */
+template<typename Real, template<typename> class Costs = costs_of>
+inline Real transit_on_edge_of(const point_t & p, const neighbors_t & neighbors, const Costs<Real> & costs)
+{
+    return transit_on_edge_weighted_of(p, neighbors, costs, 1);
+}
+
+inline double transit_on_edge(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
+{
+    return transit_on_edge_of(p, neighbors, costs);
+}
+
 /** Find the transit in minimal cost within the given simplexes.
 
     That is, find the minimal distance between the given point
     and one of the edges formed by the sequence of pairs of neighbors.
     Neighbors should thus be given in clockwise order.
     The minimal transit is searched across 1/eps distances,
-    regularly spaced on each edge. */
-inline double transit_in_simplex(const point_t & p, const neighbors_t & neighbors, const costs_t & costs, double eps)
+    regularly spaced on each edge.
+    The slowness (the inverse of the speed) around p scales the distances. */
+template<typename Real, template<typename> class Costs = costs_of>
+inline Real transit_in_simplex_weighted_of(const point_t & p, const neighbors_t & neighbors, const Costs<Real> & costs, double eps, double slowness)
 {
-    double mincost = std::numeric_limits<double>::infinity();
+    const Real s = static_cast<Real>(slowness);
+    const Real inf = std::numeric_limits<Real>::infinity();
+    Real mincost = inf;
+    Real around[neighbors_t::capacity()];
+    neighbors_costs(neighbors, costs, around);
+    const size_t n = neighbors.size();
 
     // Special case: having a single point with a cost in the neighborhood.
     // e.g. the seed.
     // This would make an empty tour and thus needs a special case.
-    auto with_cost = [&costs] (const point_t& i) {return has_cost(i,costs);};
-    if( std::count_if(begin(neighbors), end(neighbors), with_cost) == 1 ) {
+    if( std::count_if(around, around + n, [inf] (Real c) {return c < inf;}) == 1 ) {
         // There is only one possible transition.
-        auto in = std::find_if( begin(neighbors), end(neighbors), with_cost);
-        mincost = costs.at(*in) + distance(p,*in);
+        size_t k = std::find_if(around, around + n, [inf] (Real c) {return c < inf;}) - around;
+        mincost = around[k] + s * static_cast<Real>(distance(p,neighbors[k]));
 
     } else {
-        for( auto edge : make_tour(neighbors) ) {
-            point_t pj = edge.first;
-            point_t pk = edge.second;
+        // The tour of the consecutive neighbors, the last one being followed by the first one.
+        for( size_t j = 0; j < n; ++j ) {
+            const size_t k = j + 1 < n ? j + 1 : 0;
+            const point_t & pj = neighbors[j];
+            const point_t & pk = neighbors[k];
 
             // Do not compute transition toward points without a cost
             // (i.e. only toward the front).
-            if( has_cost(pj, costs) and has_cost(pk, costs) ) {
+            if( around[j] < inf and around[k] < inf ) {
                 // Cost of the transition from/to p from/to edge e.
                 // This is the simplest way to minimize the transit, even if not the most efficient.
+                // The samples are walked in double precision, so that their number does not depend on Real.
                 for( double z=0; z<=1; z+=eps) {
                     double xj = x(pj); double yj = y(pj);
                     double xk = x(pk); double yk = y(pk);
                     double zx = ( z*xj + (1-z)*xk );
                     double zy = ( z*yj + (1-z)*yk );
-                    point_t n; x(n) = zx, y(n)=zy;
+                    point_t z_point; x(z_point) = zx, y(z_point)=zy;
 
                     // Linear interpolation of costs.
-                    double c = z*costs.at(pj) + (1-z)*costs.at(pk) + distance(p, n);
+                    const Real zr = static_cast<Real>(z);
+                    Real c = zr*around[j] + (1-zr)*around[k] + s * static_cast<Real>(distance(p, z_point));
                     if( c < mincost ) {
                         mincost = c;
                     }
                 } // for z
 
                 // If the front is reached on a single point.
-            } else if(has_cost(pj, costs) and not has_cost(pk, costs)) {
-                double c = costs.at(pj) + distance(p,pj);
+            } else if(around[j] < inf and not (around[k] < inf)) {
+                Real c = around[j] + s * static_cast<Real>(distance(p,pj));
                 if( c < mincost ) {
                     mincost = c;
                 }
-            } else if(not has_cost(pj, costs) and has_cost(pk, costs)) {
-                double c = costs.at(pk) + distance(p,pk);
+            } else if(not (around[j] < inf) and around[k] < inf) {
+                Real c = around[k] + s * static_cast<Real>(distance(p,pk));
                 if( c < mincost ) {
                     mincost = c;
                 }
@@ -237,81 +961,543 @@ inline double transit_in_simplex(const point_t & p, const neighbors_t & neighbor
         } // for edge
     }
 
-    // Should be near the front (and thus have found a transit).
-    assert(mincost < std::numeric_limits<double>::infinity());
+    // Should be near the front (and thus have found a transit), unless p is impassable (see neighbors_grid_if).
+    assert(neighbors.empty() or mincost < std::numeric_limits<Real>::infinity());
     return mincost;
 }
 
-/** Propagate the front from the given seed, during the given number of iterations.
+inline double transit_in_simplex_weighted(const point_t & p, const neighbors_t & neighbors, const costs_t & costs, double eps, double slowness)
+{
+    return transit_in_simplex_weighted_of(p, neighbors, costs, eps, slowness);
+}
+
+/** Find the transit in minimal cost within the given simplexes, at unit speed. */
+template<typename Real, template<typename> class Costs = costs_of>
+inline Real transit_in_simplex_of(const point_t & p, const neighbors_t & neighbors, const Costs<Real> & costs, double eps)
+{
+    return transit_in_simplex_weighted_of(p, neighbors, costs, eps, 1);
+}
+
+inline double transit_in_simplex(const point_t & p, const neighbors_t & neighbors, const costs_t & costs, double eps)
+{
+    return transit_in_simplex_of(p, neighbors, costs, eps);
+}
+
+/** Find the exact transit of minimal cost from a given point across a single edge.
+
+    Costs are linearly interpolated along the edge [pj,pk],
+    and the function minimizes, in closed form, for z in [0,1]:
+        z*cj + (1-z)*ck + distance(p, z*pj + (1-z)*pk)
+    This is the classical triangle update of the Fast Marching method.
+
+    If the interior minimum does not lie on the edge, or if the cost difference
+    along the edge is larger than its length (the front would travel faster than unit speed),
+    the transit comes from one of the end points (causality condition).
+
+    At a slowness s (the inverse of the speed), the minimum is the one of the costs divided by s, times s. */
+template<typename Real>
+inline Real transit_across_edge_of(const point_t & p, const point_t & pj, Real cj, const point_t & pk, Real ck, double slowness = 1)
+{
+    if( slowness != 1 ) {
+        const Real s = static_cast<Real>(slowness);
+        return s * transit_across_edge_of(p, pj, cj / s, pk, ck / s);
+    }
+
+    Real mincost = std::min( cj + static_cast<Real>(distance(p,pj)), ck + static_cast<Real>(distance(p,pk)) );
+
+    // Edge vector (from pk to pj) and p relative to pk.
+    Real ex = static_cast<Real>(x(pj) - x(pk)); Real ey = static_cast<Real>(y(pj) - y(pk));
+    Real ax = static_cast<Real>(x(p)  - x(pk)); Real ay = static_cast<Real>(y(p)  - y(pk));
+    Real l2 = ex*ex + ey*ey;
+    Real d = cj - ck;
+
+    if( d*d < l2 ) {
+        // Orthogonal projection of p on the edge line, and squared distance to it.
+        Real t0 = (ax*ex + ay*ey) / l2;
+        Real h2 = std::max(Real(0), ax*ax + ay*ay - t0*t0*l2);
+        // Zero of the derivative of the (convex) cost along the edge line.
+        Real z = t0 - d * std::sqrt(h2) / std::sqrt(l2 * (l2 - d*d));
+        if( 0 < z and z < 1 ) {
+            Real c = ck + z*d + std::sqrt( l2*(z-t0)*(z-t0) + h2 );
+            if( c < mincost ) {
+                mincost = c;
+            }
+        }
+    }
+    return mincost;
+}
+
+inline double transit_across_edge(const point_t & p, const point_t & pj, double cj, const point_t & pk, double ck, double slowness = 1)
+{
+    return transit_across_edge_of(p, pj, cj, pk, ck, slowness);
+}
+
+/** Find the exact transit in minimal cost within the given simplexes.
+
+    Same as transit_in_simplex, but the minimal transit on each edge is computed
+    analytically (see transit_across_edge), instead of being searched across 1/eps samples.
+    Neighbors should thus be given in clockwise order.
+    The slowness (the inverse of the speed) around p scales the distances. */
+template<typename Real, template<typename> class Costs = costs_of>
+inline Real transit_in_simplex_exact_weighted_of(const point_t & p, const neighbors_t & neighbors, const Costs<Real> & costs, double slowness)
+{
+    const Real s = static_cast<Real>(slowness);
+    const Real inf = std::numeric_limits<Real>::infinity();
+    Real mincost = inf;
+    Real around[neighbors_t::capacity()];
+    neighbors_costs(neighbors, costs, around);
+    const size_t n = neighbors.size();
+
+    // A single neighbor would make an empty tour.
+    if( n == 1 and around[0] < inf ) {
+        return around[0] + s * static_cast<Real>(distance(p,neighbors[0]));
+    }
+
+    // The tour of the consecutive neighbors, the last one being followed by the first one.
+    for( size_t j = 0; j < n and n > 1; ++j ) {
+        const size_t k = j + 1 < n ? j + 1 : 0;
+        const point_t & pj = neighbors[j];
+        const point_t & pk = neighbors[k];
+        Real c;
+        if( around[j] < inf and around[k] < inf ) {
+            c = transit_across_edge_of(p, pj, around[j], pk, around[k], slowness);
+
+            // If the front is reached on a single point.
+        } else if( around[j] < inf ) {
+            c = around[j] + s * static_cast<Real>(distance(p,pj));
+        } else if( around[k] < inf ) {
+            c = around[k] + s * static_cast<Real>(distance(p,pk));
+        } else {
+            continue;
+        }
+        if( c < mincost ) {
+            mincost = c;
+        }
+    } // for edge
+
+    // Should be near the front (and thus have found a transit), unless p is impassable (see neighbors_grid_if).
+    assert(neighbors.empty() or mincost < std::numeric_limits<Real>::infinity());
+    return mincost;
+}
+
+inline double transit_in_simplex_exact_weighted(const point_t & p, const neighbors_t & neighbors, const costs_t & costs, double slowness)
+{
+    return transit_in_simplex_exact_weighted_of(p, neighbors, costs, slowness);
+}
+
+/** Find the exact transit in minimal cost within the given simplexes, at unit speed. */
+template<typename Real, template<typename> class Costs = costs_of>
+inline Real transit_in_simplex_exact_of(const point_t & p, const neighbors_t & neighbors, const Costs<Real> & costs)
+{
+    return transit_in_simplex_exact_weighted_of(p, neighbors, costs, 1);
+}
+
+inline double transit_in_simplex_exact(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
+{
+    return transit_in_simplex_exact_of(p, neighbors, costs);
+}
+
+//! A starting point of the propagation, along with its initial cost.
+struct seed_t
+{
+    point_t point;
+    double cost;
+};
+
+//! Index of the seed from which each point of a grid has been reached.
+using labels_t = std::vector<size_t>;
+//! Label of the points which have not been reached.
+const size_t no_label = std::numeric_limits<size_t>::max();
+
+/** Costs of a propagation from several seeds, along with the seed from which each point has been reached.
+
+    The labels thus form a discrete geodesic Voronoi partition of the grid. */
+struct labeled_costs_t
+{
+    labeled_costs_t(const grid_t & grid) : costs(grid), labels(grid.size(), no_label) {}
+    costs_t costs;
+    labels_t labels;
+};
+
+/** Counters and timers of a propagation, filled by algo_propagate if asked for.
+
+  The instrumentation is only compiled in if ALGOPATTERN_STATS is defined,
+  it vanishes otherwise (and the stats are then left untouched).
+  Nothing is printed: the caller reads the stats once the propagation is over.
+  Timers are in seconds, and add the time spent in the neighborhoods,
+  in the transits, and in popping/updating the front.
+*/
+struct algo_stats_t
+{
+    size_t accepted = 0;
+    size_t neighborhoods = 0;
+    size_t transits = 0;
+    size_t pushes = 0;
+    size_t pops = 0;
+    size_t max_front = 0;
+    double neighbors_time = 0;
+    double transit_time = 0;
+    double front_time = 0;
+};
+
+#ifdef ALGOPATTERN_STATS
+//! Add the time spent in its scope to the given timer of the stats (if any).
+class stats_timer_t
+{
+    public:
+        stats_timer_t(algo_stats_t * stats, double algo_stats_t::* timer) : _stats(stats), _timer(timer)
+        {
+            if( _stats ) {
+                _start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~stats_timer_t()
+        {
+            if( _stats ) {
+                _stats->*_timer += std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+            }
+        }
+
+    protected:
+        algo_stats_t * _stats;
+        double algo_stats_t::* _timer;
+        std::chrono::steady_clock::time_point _start;
+};
+
+//! Evaluate f(), adding its duration to the given timer of the stats (if any).
+template<typename F>
+auto stats_timed(algo_stats_t * stats, double algo_stats_t::* timer, F f) -> decltype(f())
+{
+    stats_timer_t scope(stats, timer);
+    return f();
+}
+
+//! Run the statement only if stats are asked for.
+#define ALGO_STATS(stats, statement) do { if(stats) { statement; } } while(0)
+//! Evaluate the expression, timing it if stats are asked for.
+#define ALGO_STATS_TIMED(stats, timer, expression) stats_timed(stats, &algo_stats_t::timer, [&](){ return expression; })
+#else
+#define ALGO_STATS(stats, statement) do { (void)(stats); } while(0)
+#define ALGO_STATS_TIMED(stats, timer, expression) (expression)
+#endif
+
+/** Propagate an already started front, during the given number of iterations.
 
   Iteratively accept points of minimal costs (see the transit function) in a neighborhood (see the neighbors function).
 
+  \param costs The costs of the points of the front, updated in place (costs_of, or any store having at and operator[] on indices and points).
+  \param labels If not null, the label of each reached point is set to the one of the accepted point from which it has been reached.
+  \param front The points from which to start the propagation.
+  \param iterations The maximum number of iterations.
+  \param progress If not null, the stream on which to print the progress.
+  \param stats If not null, the counters and timers to increment (see algo_stats_t).
+*/
+template<typename Front, typename N, typename T, typename Real, template<typename> class Costs>
+void algo_propagate(Costs<Real> & costs, labels_t * labels, Front & front, unsigned int iterations, N & neighbors, T & transit, std::ostream * progress = &std::cout, algo_stats_t * stats = nullptr)
+{
+    const grid_t & grid = costs.grid();
+
+    unsigned int i=0;
+    while(i++ < iterations and not front.empty()) {
+        if( progress ) {
+            *progress << "\r" << i << "/" << iterations;
+        }
+
+        // Accept the node with the min cost and update neighbors.
+        // Accept the considered node with the min cost.
+        size_t ia = ALGO_STATS_TIMED(stats, front_time, front.pop());
+        ALGO_STATS(stats, stats->pops++; stats->accepted++);
+        point_t accepted = grid.point(ia);
+        // Consider neighbors of the accepted node.
+        neighbors_t around = ALGO_STATS_TIMED(stats, neighbors_time, neighbors(accepted));
+        ALGO_STATS(stats, stats->neighborhoods++);
+        assert(around.size()>0);
+        // The indices of the neighbors on the grid, if they are the ones of the costs.
+        const bool indexed = neighbors_indexed(around, costs);
+        for( size_t k = 0; k < around.size(); ++k ) {
+            const point_t & n = around[k];
+            size_t in = indexed ? around.index(k) : grid.index(n);
+            // If the node has not been accepted yet
+            // (i.e. the node is "open", or is in the front with a tentative cost).
+            if( not (costs.at(in) < std::numeric_limits<Real>::infinity()) or front.contains(in) ) {
+                // Compute costs.
+                neighbors_t simplex = ALGO_STATS_TIMED(stats, neighbors_time, neighbors(n));
+                Real c = ALGO_STATS_TIMED(stats, transit_time, transit(n, simplex, costs));
+                ALGO_STATS(stats, stats->neighborhoods++; stats->transits++);
+                if( c < costs[in] ) {
+                    costs[in] = c;
+                    ALGO_STATS_TIMED(stats, front_time, front.update(in, c));
+                    ALGO_STATS(stats, stats->pushes++; stats->max_front = std::max(stats->max_front, front.size()));
+                    if( labels ) {
+                        (*labels)[in] = (*labels)[ia];
+                    }
+                }
+            }
+        }
+    }
+}
+
+//! Wraps a type so that template parameters are not deduced from it (they are then given or defaulted).
+template<typename T>
+struct non_deduced
+{
+    using type = T;
+};
+
+/** Propagate the front from the given seed, during the given number of iterations.
+
+  The front can be chosen at compile time (see heap_front and bucket_front).
+
+  \param grid The grid on which the costs are computed.
   \param seed The point with NULL cost.
   \param iterations The maximum number of iterations. If ommitted, the costs of all the points of the grid will be computed.
-  \return The costs map: <points coordinates> => <cost>
+  \param stats If not null, filled with the counters and timers of the propagation (see algo_stats_t).
+  \param progress If not null, the stream on which to print the progress.
+  \return The costs grid: <points index> => <cost>
+
+  \tparam Real The type of the costs, given explicitly, along with a transit of the same type
+                (e.g. algo_run<front_t,float>(..., transit_on_edge_of<float>)).
 */
-inline costs_t algo_run(
+template<typename Front = front_t, typename Real = double>
+costs_of<Real> algo_run(
+        const grid_t & grid,
         point_t seed,
         unsigned int iterations,
         std::function< neighbors_t(const point_t&) > neighbors,
-        std::function< double(const point_t &, const neighbors_t &, const costs_t &) > transit
+        typename non_deduced< std::function< Real(const point_t &, const neighbors_t &, const costs_of<Real> &) > >::type transit,
+        algo_stats_t * stats = nullptr,
+        std::ostream * progress = &std::cout
     )
 {
-    costs_t costs;
+    costs_of<Real> costs(grid);
 
     // Make a priority queue of considered nodes.
-    auto compare = [&costs](const point_t& lhs, const point_t& rhs) { return costs[lhs] > costs[rhs]; };
-    front_t front(compare);
+    Front front(grid);
 
     // Start the front from the seed
     costs[seed] = 0;
-    front.push(seed);
+    front.push(grid.index(seed), 0);
+    ALGO_STATS(stats, stats->pushes++; stats->max_front = 1);
 
-    unsigned int i=0;
-    while(i++ < iterations and not front.empty()) {
-        std::cout << "\r" << i << "/" << iterations;
+    algo_propagate(costs, nullptr, front, iterations, neighbors, transit, progress, stats);
+    return costs;
+}
 
-        // Accept the node with the min cost and update neighbors.
-        // Accept the considered node with the min cost.
-        point_t accepted = front.top(); front.pop();
-        // Consider neighbors of the accepted node.
+/** Propagate a single front from several seeds, during the given number of iterations.
+
+  Each seed is labelled by its rank in the given sequence,
+  and each point gets the label of the seed with which it has the minimal cost.
+
+  \param grid The grid on which the costs are computed.
+  \param seeds The starting points, with their initial costs.
+  \param iterations The maximum number of iterations.
+  \param stats If not null, filled with the counters and timers of the propagation (see algo_stats_t).
+  \param progress If not null, the stream on which to print the progress.
+  \return The costs grid, along with the labels grid.
+*/
+template<typename Front = front_t>
+labeled_costs_t algo_run(
+        const grid_t & grid,
+        const std::vector<seed_t> & seeds,
+        unsigned int iterations,
+        std::function< neighbors_t(const point_t&) > neighbors,
+        std::function< double(const point_t &, const neighbors_t &, const costs_t &) > transit,
+        algo_stats_t * stats = nullptr,
+        std::ostream * progress = &std::cout
+    )
+{
+    labeled_costs_t result(grid);
+    Front front(grid);
+
+    // Start the front from all the seeds.
+    for( size_t k = 0; k < seeds.size(); ++k ) {
+        size_t idx = grid.index(seeds[k].point);
+        // Seeds on the same point: keep the cheapest.
+        if( seeds[k].cost < result.costs[idx] ) {
+            result.costs[idx] = seeds[k].cost;
+            result.labels[idx] = k;
+            front.update(idx, seeds[k].cost);
+            ALGO_STATS(stats, stats->pushes++);
+        }
+    }
+    ALGO_STATS(stats, stats->max_front = front.size());
+
+    algo_propagate(result.costs, &result.labels, front, iterations, neighbors, transit, progress, stats);
+    return result;
+}
+
+//! Cost of a point-to-point query, along with the number of accepted (expanded) points.
+struct goal_cost_t
+{
+    double cost;
+    size_t expanded;
+};
+
+/** Scale of the euclidean heuristic keeping the A* queries in simplexes consistent (see algo_goal_propagate).
+
+  In a simplex, the cost of a point exceeds the one of each neighbor it is computed from
+  by at least their distance times the cosine of the widest angle between consecutive neighbors
+  of the stencil (the one between the characteristic crossing the simplex and the neighbor).
+  A heuristic growing by less than that, from a neighbor to the point, accepts the neighbor first.
+  That is cos(45°) for the 8 neighbors, but zero for the 4 neighbors (the plain Dijkstra's order).
+*/
+template<typename Stencil>
+double simplex_heuristic_scale()
+{
+    double widest = 0;
+    for( size_t d = 0; d < Stencil::size; ++d ) {
+        const size_t e = (d+1) % Stencil::size;
+        const double xd = Stencil::xy[2*d], yd = Stencil::xy[2*d+1];
+        const double xe = Stencil::xy[2*e], ye = Stencil::xy[2*e+1];
+        widest = std::max(widest, std::acos( (xd*xe + yd*ye) / (std::sqrt(xd*xd + yd*yd) * std::sqrt(xe*xe + ye*ye)) ));
+    }
+    // Do not let the rounding of a right angle give a (tiny) positive scale.
+    return std::max(0.0, std::cos(widest) - 1e-12);
+}
+
+/** Propagate an already started front toward a goal, until it is accepted.
+
+  The front is ordered by the cost plus a consistent heuristic:
+  the euclidean distance to the goal, times the given scale.
+  - With on_edge, a scale of one is consistent, because the cost of an edge is its length.
+  - With in_simplex, the scale should be simplex_heuristic_scale<Stencil>() (e.g. 0.707 for 8 neighbors):
+    with a larger one, the points are not accepted by increasing costs anymore,
+    some transits miss points not reached yet, and the cost is overestimated (by up to a fraction of a percent with a scale of one).
+  - With a speed field, the scale should also be multiplied by the smallest slowness (the inverse of the fastest speed).
+  With a consistent heuristic, the cost of the goal is the one of a full propagation.
+  The costs of the points accepted before the goal are kept in the given costs.
+
+  \param costs The costs of the points of the front, updated in place
+               (a costs_of, or any store indexing the points by its grid(), see corridor_costs).
+  \param front The points from which to start the propagation, with their cost plus their heuristic as keys.
+  \param goal The point at which to stop.
+  \param iterations The maximum number of iterations.
+  \param heuristic_scale The factor of the euclidean distance to the goal.
+  \return The cost of the goal (infinite if it has not been reached), and the number of accepted points.
+*/
+template<typename Front, typename Real, template<typename> class Costs, typename N, typename T>
+goal_cost_t algo_goal_propagate(Costs<Real> & costs, Front & front, const point_t & goal, unsigned int iterations, N & neighbors, T & transit, double heuristic_scale = 1)
+{
+    // A grid_t, or any index of the points having index(point) and point(index).
+    const auto & grid = costs.grid();
+    const size_t ig = grid.index(goal);
+    goal_cost_t result{std::numeric_limits<double>::infinity(), 0};
+
+    while(result.expanded < iterations and not front.empty()) {
+        // Accept the node with the min cost plus heuristic.
+        size_t ia = front.pop();
+        result.expanded++;
+        if( ia == ig ) {
+            result.cost = costs[ia];
+            break;
+        }
+        point_t accepted = grid.point(ia);
         neighbors_t around = neighbors(accepted);
-        assert(around.size()>0);
-        for( auto n : around ) {
-            // If no cost has been computed (i.e. the node is "open").
-            if( not has_cost(n, costs)) {
-                // Compute costs.
-                costs[n] = transit(n, neighbors(n), costs);
-                front.push(n);
+        const bool indexed = neighbors_indexed(around, costs);
+        for( size_t k = 0; k < around.size(); ++k ) {
+            const point_t & n = around[k];
+            size_t in = indexed ? around.index(k) : grid.index(n);
+            if( not (costs.at(in) < std::numeric_limits<Real>::infinity()) or front.contains(in) ) {
+                double c = transit(n, neighbors(n), costs);
+                if( c < costs[in] ) {
+                    costs[in] = c;
+                    front.update(in, c + heuristic_scale * distance(n, goal));
+                }
             }
         }
     }
-    return costs;
+    return result;
+}
+
+/** Compute the cost from the seed to the goal only, with the A* heuristic (see algo_goal_propagate).
+
+  The number of accepted points thus grows with the length of the path,
+  instead of with the area of the grid.
+  The costs and the front are however allocated (and initialized) for the whole grid:
+  for repeated queries, the overload taking a workspace (see workspace.h) only touches the points it reaches.
+
+  \param grid The grid on which the costs are computed.
+  \param seed The point with NULL cost.
+  \param goal The point at which to stop.
+  \param iterations The maximum number of iterations.
+  \param heuristic_scale The factor of the euclidean distance to the goal.
+  \return The cost of the goal, and the number of accepted points.
+*/
+template<typename Front = front_t>
+goal_cost_t algo_goal(
+        const grid_t & grid,
+        point_t seed,
+        point_t goal,
+        unsigned int iterations,
+        std::function< neighbors_t(const point_t&) > neighbors,
+        std::function< double(const point_t &, const neighbors_t &, const costs_t &) > transit,
+        double heuristic_scale = 1
+    )
+{
+    costs_t costs(grid);
+    Front front(grid);
+
+    costs[seed] = 0;
+    front.push(grid.index(seed), heuristic_scale * distance(seed, goal));
+
+    return algo_goal_propagate(costs, front, goal, iterations, neighbors, transit, heuristic_scale);
 }
 
 /** @} Algorithm */
 
 
 
-/** Pretty print a costs map. */
-void grid_print( const costs_t & grid, point_t pmin, point_t pmax, double step,
+/** Pretty print a costs grid. */
+template<typename Real>
+void grid_print( const costs_of<Real> & costs,
+        std::ostream& out = std::cout, std::string sep = "  ", std::string end = "\n",
+        unsigned int width = 5, char fill = ' ', unsigned int prec = 3)
+{
+    const grid_t & grid = costs.grid();
+    out << std::setw(width) << std::setfill(fill) << std::setprecision(prec);
+
+    out << "   x:";
+    for( size_t i=0; i < grid.width; ++i) {
+        out << sep << std::setw(width) << std::setfill(fill) << x(grid.point(i,0));
+    }
+    out << end;
+    out << "  y" << end;;
+    for( size_t j=grid.height; j-- > 0; ) {
+        out << std::setw(width) << std::setfill(fill) << y(grid.point(0,j)) << ":";
+        for( size_t i=0; i < grid.width; ++i) {
+            size_t idx = grid.index(i,j);
+            if( costs.at(idx) < std::numeric_limits<Real>::infinity() ) {
+                out << sep << std::setw(width) << std::setfill(fill) << std::setprecision(prec) << costs.at(idx);
+            } else {
+                out << sep << std::setw(width) << std::setfill(fill) <<  ".";
+            }
+        }
+        out << end;
+    }
+    out << end;
+}
+
+/** Pretty print a labels grid. */
+void labels_print( const labels_t & labels, const grid_t & grid,
         std::ostream& out = std::cout, std::string sep = "  ", std::string end = "\n",
         unsigned int width = 5, char fill = ' ', unsigned int prec = 3)
 {
+    assert(labels.size() == grid.size());
     out << std::setw(width) << std::setfill(fill) << std::setprecision(prec);
 
     out << "   x:";
-    for( double px=x(pmin); px<=x(pmax); px+=step) {
-        out << sep << std::setw(width) << std::setfill(fill) << px;
+    for( size_t i=0; i < grid.width; ++i) {
+        out << sep << std::setw(width) << std::setfill(fill) << x(grid.point(i,0));
     }
     out << end;
     out << "  y" << end;;
-    for( double py=y(pmax); py>=y(pmin); py-=step) {
-        out << std::setw(width) << std::setfill(fill) << py << ":";
-        for( double px=x(pmin); px<=x(pmax); px+=step) {
-            point_t p; x(p)=px; y(p)=py;
-            if( has_cost(p,grid) ) {
-                out << sep << std::setw(width) << std::setfill(fill) << std::setprecision(prec) << grid.at(p);
+    for( size_t j=grid.height; j-- > 0; ) {
+        out << std::setw(width) << std::setfill(fill) << y(grid.point(0,j)) << ":";
+        for( size_t i=0; i < grid.width; ++i) {
+            size_t idx = grid.index(i,j);
+            if( labels[idx] != no_label ) {
+                out << sep << std::setw(width) << std::setfill(fill) << labels[idx];
             } else {
                 out << sep << std::setw(width) << std::setfill(fill) <<  ".";
             }
@@ -11,6 +11,10 @@
 #include <functional>
 
 #include "code.h"
+#include "batch.h"
+#include "tiled.h"
+#include "simd.h"
+#include "workspace.h"
 
 
 
@@ -19,50 +23,44 @@ namespace neighbors {
     struct Neighborhood
     {
         public:
-            Neighborhood( const point_t & pmin_, const point_t & pmax_) : pmin(pmin_), pmax(pmax_) {}
+            Neighborhood( const grid_t & grid_) : grid(grid_) {}
             neighbors_t operator()(const point_t & p)
             {
                 return static_cast<T*>(this)->call(p);
             }
-        protected:
-            const point_t & pmin, pmax;
+            const grid_t grid;
     };
 
     class quad_grid : public Neighborhood<quad_grid>
     {
         public:
-            quad_grid(double grid_step_, const point_t & pmin, const point_t & pmax) : Neighborhood<quad_grid>(pmin,pmax), grid_step(grid_step_) {}
+            quad_grid(const grid_t & grid_) : Neighborhood<quad_grid>(grid_) {}
             neighbors_t call(const point_t & p)
             {
-                // neighborhood (list) of relative locations (vector)
-                // Should be given in [clockwise] order.
-                std::vector<point_t> directions{{1,0},{0,-1},{-1,0},{0,1}};
-                return neighbors_grid(p,grid_step,pmin,pmax,directions);
+                // The stencil holds the relative locations, in [clockwise] order.
+                return neighbors_grid<quad_stencil>(p,grid);
             }
-        protected:
-            double grid_step;
     };
 
     class octo_grid : public Neighborhood<octo_grid>
     {
         public:
-            octo_grid(double grid_step_, const point_t & pmin, const point_t & pmax) : Neighborhood<octo_grid>(pmin,pmax),  grid_step(grid_step_) {}
+            octo_grid(const grid_t & grid_) : Neighborhood<octo_grid>(grid_) {}
             neighbors_t call(const point_t & p)
             {
-                std::vector<point_t> directions{{1,0},{1,-1},{0,-1},{-1,-1},{-1,0},{-1,1},{0,1},{1,1}};
-                return neighbors_grid(p,grid_step,pmin,pmax,directions);
+                return neighbors_grid<octo_stencil>(p,grid);
             }
-        protected:
-            double grid_step;
     };
 }
 
 namespace transit {
+    //! The costs store is given at compile time (e.g. the costs of a workspace_t).
     template <class T> 
     class HopfLax
     {
         public:
-            double operator()(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
+            template<typename Costs>
+            double operator()(const point_t & p, const neighbors_t & neighbors, const Costs & costs)
             {
                 return static_cast<T*>(this)->call(p,neighbors,costs);
             }
@@ -71,9 +69,10 @@ namespace transit {
     class on_edge : public HopfLax<on_edge>
     {
         public:
-            double call(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
+            template<typename Costs>
+            double call(const point_t & p, const neighbors_t & neighbors, const Costs & costs)
             {
-                return transit_on_edge(p,neighbors,costs);
+                return transit_on_edge_of(p,neighbors,costs);
             }
     };
 
@@ -81,9 +80,42 @@ namespace transit {
     {
         public:
             in_simplex( double epsilon ) : eps(epsilon) {assert(0 < epsilon and epsilon < 1);}
+            template<typename Costs>
+            double call(const point_t & p, const neighbors_t & neighbors, const Costs & costs)
+            {
+                return transit_in_simplex_of(p,neighbors,costs,eps);
+            }
+        protected:
+            double eps;
+    };
+
+    class in_simplex_exact : public HopfLax<in_simplex_exact>
+    {
+        public:
+            template<typename Costs>
+            double call(const point_t & p, const neighbors_t & neighbors, const Costs & costs)
+            {
+                return transit_in_simplex_exact_of(p,neighbors,costs);
+            }
+    };
+
+    //! Vectorized with the best kernels of the CPU (see simd.h), on a costs_t only.
+    class on_edge_simd : public HopfLax<on_edge_simd>
+    {
+        public:
             double call(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
             {
-                return transit_in_simplex(p,neighbors,costs,eps);
+                return transit_on_edge_simd(p,neighbors,costs);
+            }
+    };
+
+    class in_simplex_simd : public HopfLax<in_simplex_simd>
+    {
+        public:
+            in_simplex_simd( double epsilon ) : eps(epsilon) {assert(0 < epsilon and epsilon < 1);}
+            double call(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
+            {
+                return transit_in_simplex_simd(p,neighbors,costs,eps);
             }
         protected:
             double eps;
@@ -91,7 +123,7 @@ namespace transit {
 }
 
 
-template<typename N, typename T>
+template<typename N, typename T, typename Front = front_t>
 class algo
 {
     protected:
@@ -99,13 +131,36 @@ class algo
         T & transit;
     public:
         algo(N & neighbors_, T & hl) : neighbors(neighbors_), transit(hl) {}
-        costs_t operator()(point_t seed, unsigned int iterations)
+        //! If progress is not null, the progress is printed on it.
+        costs_t operator()(point_t seed, unsigned int iterations, std::ostream * progress = &std::cout)
+        {
+            return algo_run<Front>(this->neighbors.grid, seed, iterations, std::ref(this->neighbors), std::ref(this->transit), nullptr, progress);
+        }
+        labeled_costs_t operator()(const std::vector<seed_t> & seeds, unsigned int iterations, std::ostream * progress = &std::cout)
+        {
+            return algo_run<Front>(this->neighbors.grid, seeds, iterations, std::ref(this->neighbors), std::ref(this->transit), nullptr, progress);
+        }
+        //! The cost from the seed to the target only (see algo_goal).
+        goal_cost_t goal(point_t seed, point_t target, unsigned int iterations, double heuristic_scale = 1)
         {
-            return algo_run(seed, iterations, std::ref(this->neighbors), std::ref(this->transit));
+            return algo_goal<Front>(this->neighbors.grid, seed, target, iterations, std::ref(this->neighbors), std::ref(this->transit), heuristic_scale);
+        }
+        /** Propagate the front from the seed in the workspace, reusing its buffers, without printing progress.
+
+            \return The costs, valid until the next run in the workspace. */
+        const touched_costs<> & operator()(workspace_t<Front> & workspace, point_t seed, unsigned int iterations)
+        {
+            return algo_run(workspace, this->neighbors.grid, seed, iterations, this->neighbors, this->transit);
+        }
+        //! The cost from the seed to the target only, in the buffers of the workspace.
+        goal_cost_t goal(workspace_t<Front> & workspace, point_t seed, point_t target, unsigned int iterations, double heuristic_scale = 1)
+        {
+            return algo_goal(workspace, this->neighbors.grid, seed, target, iterations, this->neighbors, this->transit, heuristic_scale);
         }
 };
 
 
+#ifndef ALGOPATTERN_NO_MAIN
 int main()
 {
     point_t seed; x(seed)= 0;y(seed)= 0;
@@ -119,33 +174,99 @@ int main()
     unsigned int maxit=300;
     double eps = 1/100.0;
 
-    neighbors::quad_grid four (step, pmin, pmax);
-    neighbors::octo_grid eight(step, pmin, pmax);
+    grid_t grid(pmin, pmax, step);
+
+    neighbors::quad_grid four (grid);
+    neighbors::octo_grid eight(grid);
 
     transit::on_edge graph;
     transit::in_simplex mesh(eps);
+    transit::in_simplex_exact exact;
 
     algo<neighbors::quad_grid,transit::on_edge> dijkstra4(four,graph);
     std::cout << "Dijkstra, 4 neighbors" << std::endl;
     costs_t cd4 = dijkstra4(seed, maxit);
     std::cout << std::endl;
-    grid_print(cd4, pmin, pmax, step);
+    grid_print(cd4);
 
     algo<neighbors::quad_grid,transit::in_simplex> fast_marching4(four,mesh);
     std::cout << "Fast marching, 4 neighbors" << std::endl;
     costs_t cfm4 = fast_marching4(seed, maxit);
     std::cout << std::endl;
-    grid_print(cfm4, pmin, pmax, step);
+    grid_print(cfm4);
+
+    algo<neighbors::quad_grid,transit::in_simplex_exact> exact_fast_marching4(four,exact);
+    std::cout << "Exact fast marching, 4 neighbors" << std::endl;
+    costs_t cxfm4 = exact_fast_marching4(seed, maxit);
+    std::cout << std::endl;
+    grid_print(cxfm4);
 
     algo<neighbors::octo_grid,transit::on_edge> dijkstra8(eight,graph);
     std::cout << "Dijkstra, 8 neighbors" << std::endl;
     costs_t cd8 = dijkstra8(seed, maxit);
     std::cout << std::endl;
-    grid_print(cd8, pmin, pmax, step);
+    grid_print(cd8);
 
     algo<neighbors::octo_grid,transit::in_simplex> fast_marching8(eight,mesh);
     std::cout << "Fast marching, 8 neighbors" << std::endl;
     costs_t cfm8 = fast_marching8(seed, maxit);
     std::cout << std::endl;
-    grid_print(cfm8, pmin, pmax, step);
+    grid_print(cfm8);
+
+    algo<neighbors::octo_grid,transit::in_simplex_exact> exact_fast_marching8(eight,exact);
+    std::cout << "Exact fast marching, 8 neighbors" << std::endl;
+    costs_t cxfm8 = exact_fast_marching8(seed, maxit);
+    std::cout << std::endl;
+    grid_print(cxfm8);
+
+    point_t target = make_point(10,10);
+    goal_cost_t gxfm8 = exact_fast_marching8.goal(seed, target, maxit, simplex_heuristic_scale<octo_stencil>());
+    std::cout << "A* exact fast marching, 8 neighbors, to (10,10): " << gxfm8.cost << " (" << gxfm8.expanded << " accepted, vs. " << cxfm8.at(target) << ")" << std::endl;
+    std::cout << std::endl;
+
+    transit::in_simplex_simd vmesh(eps);
+    algo<neighbors::octo_grid,transit::in_simplex_simd> vectorized_fast_marching8(eight,vmesh);
+    std::cout << "Fast marching, 8 neighbors, vectorized (" << simd_kernels().name << ")" << std::endl;
+    costs_t cvfm8 = vectorized_fast_marching8(seed, maxit);
+    std::cout << std::endl;
+    grid_print(cvfm8);
+
+    // Accept nodes by buckets of costs as wide as the grid step.
+    algo<neighbors::octo_grid,transit::in_simplex_exact,bucket_front<std::ratio<1>>> untidy_fast_marching8(eight,exact);
+    std::cout << "Untidy fast marching, 8 neighbors" << std::endl;
+    costs_t cufm8 = untidy_fast_marching8(seed, maxit);
+    std::cout << std::endl;
+    grid_print(cufm8);
+
+    // The same operators, over 7x7 tiles solved by 2 threads.
+    tiled_algo<neighbors::octo_grid,transit::in_simplex_exact> tiled_fast_marching8(eight,exact,7,2);
+    std::cout << "Tiled fast marching, 8 neighbors" << std::endl;
+    costs_t ctfm8 = tiled_fast_marching8(seed, /*rounds=*/100);
+    grid_print(ctfm8);
+
+    std::vector<seed_t> seeds{ {{0,0},0}, {{10,10},0}, {{12,-3},2} };
+    std::cout << "Dijkstra, 8 neighbors, 3 seeds" << std::endl;
+    labeled_costs_t lcd8 = dijkstra8(seeds, maxit);
+    std::cout << std::endl;
+    grid_print(lcd8.costs);
+    labels_print(lcd8.labels, lcd8.costs.grid());
+
+    std::vector<query_t> queries{ {{0,0},maxit}, {{10,10},maxit}, {{12,-3},maxit}, {{-5,15},maxit} };
+    work_stealing_pool pool(2);
+    std::cout << "Batch of Dijkstra, 8 neighbors" << std::endl;
+    std::vector<costs_t> batch = batch_run(grid, queries, pool, batch_propagation(std::ref(eight), std::ref(graph)));
+    for( size_t q = 0; q < queries.size(); ++q ) {
+        std::cout << "from (" << x(queries[q].seed) << "," << y(queries[q].seed) << ") to (5,5): " << batch[q].at(make_point(5,5)) << std::endl;
+    }
+    std::cout << std::endl;
+
+    // The same queries, one after the other, reusing the same buffers.
+    workspace_t<> workspace;
+    std::cout << "Successive Dijkstra, 8 neighbors, in a workspace" << std::endl;
+    for( const query_t & query : queries ) {
+        const touched_costs<> & costs = dijkstra8(workspace, query.seed, query.iterations);
+        std::cout << "from (" << x(query.seed) << "," << y(query.seed) << ") to (5,5): " << costs.at(make_point(5,5)) << std::endl;
+    }
+    std::cout << std::endl;
 }
+#endif // ALGOPATTERN_NO_MAIN
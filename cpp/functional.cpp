@@ -11,32 +11,40 @@
 #include <functional>
 
 #include "code.h"
+#include "batch.h"
+#include "sweep.h"
+#include "speed.h"
+#include "paths.h"
+#include "simd.h"
 
 namespace neighbors {
 
     using Neighborhood = std::function< neighbors_t(const point_t&) >;
 
     template<typename F, typename...Fargs>
-    Neighborhood make(F f, const point_t& pmin, const point_t& pmax, double grid_step, Fargs...args)
+    Neighborhood make(F f, const grid_t& grid, Fargs...args)
     {
-        return [f,pmin,pmax,grid_step,args...]
+        return [f,grid,args...]
             (const point_t& p)
             ->neighbors_t
-            { return f(p, pmin, pmax, grid_step, args...); };
+            { return f(p, grid, args...); };
     }
 
-    neighbors_t quad_grid(const point_t& p, const point_t& pmin, const point_t& pmax, double grid_step)
+    neighbors_t quad_grid(const point_t& p, const grid_t& grid)
     {
-        // neighborhood (list) of relative locations (vector)
-        // Should be given in [clockwise] order.
-        std::vector<point_t> directions{{1,0},{0,-1},{-1,0},{0,1}};
-        return neighbors_grid(p,grid_step,pmin,pmax,directions);
+        // The stencil holds the relative locations, in [clockwise] order.
+        return neighbors_grid<quad_stencil>(p,grid);
     }
 
-    neighbors_t octo_grid(const point_t& p, const point_t& pmin, const point_t& pmax, double grid_step)
+    neighbors_t octo_grid(const point_t& p, const grid_t& grid)
     {
-        std::vector<point_t> directions{{1,0},{1,-1},{0,-1},{-1,-1},{-1,0},{-1,1},{0,1},{1,1}};
-        return neighbors_grid(p,grid_step,pmin,pmax,directions);
+        return neighbors_grid<octo_stencil>(p,grid);
+    }
+
+    //! Obstacles of the speed field are not neighbors.
+    neighbors_t octo_grid_field(const point_t& p, const grid_t& grid, const speed_field_t& field)
+    {
+        return neighbors_grid<octo_stencil>(p,grid,field);
     }
 }
 
@@ -63,14 +71,53 @@ namespace transit {
         return transit_in_simplex(p,neighbors,costs,epsilon);
     }
 
+    double in_simplex_exact(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
+    {
+        return transit_in_simplex_exact(p,neighbors,costs);
+    }
+
+    //! Vectorized, with the best kernels of the CPU (see simd.h).
+    double on_edge_simd(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
+    {
+        return transit_on_edge_simd(p,neighbors,costs);
+    }
+
+    double in_simplex_simd(const point_t & p, const neighbors_t & neighbors, const costs_t & costs, double epsilon)
+    {
+        return transit_in_simplex_simd(p,neighbors,costs,epsilon);
+    }
+
+    double in_simplex_exact_speed(const point_t & p, const neighbors_t & neighbors, const costs_t & costs, const speed_field_t & field)
+    {
+        return transit_in_simplex_exact_speed(p,neighbors,costs,field);
+    }
+
+}
+
+//! If progress is not null, the progress is printed on it.
+costs_t algo(const grid_t& grid, neighbors::Neighborhood neighbors, transit::HopfLax transit, point_t seed, unsigned int iterations, std::ostream* progress = &std::cout)
+{
+    return algo_run(grid, seed, iterations, neighbors, transit, nullptr, progress);
 }
 
-costs_t algo(neighbors::Neighborhood neighbors, transit::HopfLax transit, point_t seed, unsigned int iterations)
+labeled_costs_t algo(const grid_t& grid, neighbors::Neighborhood neighbors, transit::HopfLax transit, const std::vector<seed_t>& seeds, unsigned int iterations, std::ostream* progress = &std::cout)
 {
-    return algo_run(seed, iterations, neighbors, transit);
+    return algo_run(grid, seeds, iterations, neighbors, transit, nullptr, progress);
 }
 
+costs_t sweep(const grid_t& grid, neighbors::Neighborhood neighbors, transit::HopfLax transit, point_t seed, unsigned int sweeps)
+{
+    return sweep_run(grid, seed, sweeps, neighbors, transit);
+}
+
+//! The cost from the seed to the target only (see algo_goal).
+goal_cost_t goal(const grid_t& grid, neighbors::Neighborhood neighbors, transit::HopfLax transit, point_t seed, point_t target, unsigned int iterations, double heuristic_scale = 1)
+{
+    return algo_goal(grid, seed, target, iterations, neighbors, transit, heuristic_scale);
+}
 
+
+#ifndef ALGOPATTERN_NO_MAIN
 int main()
 {
     point_t seed; x(seed)= 0;y(seed)= 0;
@@ -83,30 +130,104 @@ int main()
     double step = 1;
     unsigned int maxit=300;
     double eps = 1/100.0;
+    grid_t grid(pmin, pmax, step);
 
-    auto four  = neighbors::make(neighbors::quad_grid, pmin, pmax, step);
-    auto eight = neighbors::make(neighbors::octo_grid, pmin, pmax, step);
+    auto four  = neighbors::make(neighbors::quad_grid, grid);
+    auto eight = neighbors::make(neighbors::octo_grid, grid);
 
     auto graph = transit::make(transit::on_edge);
     auto mesh  = transit::make(transit::in_simplex, eps);
+    auto exact = transit::make(transit::in_simplex_exact);
 
     std::cout << "Dijkstra, 4 neighbors" << std::endl;
-    costs_t cd4 = algo(four, graph, seed, maxit);
+    costs_t cd4 = algo(grid, four, graph, seed, maxit);
     std::cout << std::endl;
-    grid_print(cd4, pmin, pmax, step);
+    grid_print(cd4);
 
     std::cout << "Fast marching, 4 neighbors" << std::endl;
-    costs_t cfm4 = algo(four, mesh, seed, maxit);
+    costs_t cfm4 = algo(grid, four, mesh, seed, maxit);
+    std::cout << std::endl;
+    grid_print(cfm4);
+
+    std::cout << "Exact fast marching, 4 neighbors" << std::endl;
+    costs_t cxfm4 = algo(grid, four, exact, seed, maxit);
     std::cout << std::endl;
-    grid_print(cfm4, pmin, pmax, step);
+    grid_print(cxfm4);
 
     std::cout << "Dijkstra, 8 neighbors" << std::endl;
-    costs_t cd8 = algo(eight, graph, seed, maxit);
+    costs_t cd8 = algo(grid, eight, graph, seed, maxit);
     std::cout << std::endl;
-    grid_print(cd8, pmin, pmax, step);
+    grid_print(cd8);
+
+    std::vector<seed_t> seeds{ {{0,0},0}, {{10,10},0}, {{12,-3},2} };
+    std::cout << "Dijkstra, 8 neighbors, 3 seeds" << std::endl;
+    labeled_costs_t lcd8 = algo(grid, eight, graph, seeds, maxit);
+    std::cout << std::endl;
+    grid_print(lcd8.costs);
+    labels_print(lcd8.labels, lcd8.costs.grid());
 
     std::cout << "Fast marching, 8 neighbors" << std::endl;
-    costs_t cfm8 = algo(eight, mesh, seed, maxit);
+    costs_t cfm8 = algo(grid, eight, mesh, seed, maxit);
+    std::cout << std::endl;
+    grid_print(cfm8);
+
+    std::cout << "Exact fast marching, 8 neighbors" << std::endl;
+    costs_t cxfm8 = algo(grid, eight, exact, seed, maxit);
+    std::cout << std::endl;
+    grid_print(cxfm8);
+
+    auto vmesh = transit::make(transit::in_simplex_simd, eps);
+    std::cout << "Fast marching, 8 neighbors, vectorized (" << simd_kernels().name << ")" << std::endl;
+    costs_t cvfm8 = algo(grid, eight, vmesh, seed, maxit);
+    std::cout << std::endl;
+    grid_print(cvfm8);
+
+    // A wall with a gap, and a slow region.
+    std::vector<float> speeds(grid.size(), 1);
+    for( long j = 0; j < 15; ++j ) {
+        speeds[grid.index(10,j)] = 0;
+    }
+    for( long i = 0; i < 5; ++i ) {
+        for( long j = 0; j < 5; ++j ) {
+            speeds[grid.index(i,j+15)] = 0.5;
+        }
+    }
+    speed_field_t field(grid, speeds);
+    auto walled = neighbors::make(neighbors::octo_grid_field, grid, field);
+    auto ground = transit::make(transit::in_simplex_exact_speed, field);
+    std::cout << "Exact fast marching, 8 neighbors, on a speed field" << std::endl;
+    costs_t cxfm8s = algo(grid, walled, ground, seed, maxit);
+    std::cout << std::endl;
+    grid_print(cxfm8s);
+
+    std::cout << "Fast sweeping, 8 neighbors" << std::endl;
+    costs_t csw8 = sweep(grid, eight, exact, seed, /*sweeps=*/10);
+    grid_print(csw8);
+
+    point_t target; x(target)=10;y(target)=10;
+    goal_cost_t gd8 = goal(grid, eight, graph, seed, target, maxit);
+    std::cout << "A* Dijkstra, 8 neighbors, to (10,10): " << gd8.cost << " (" << gd8.expanded << " accepted, vs. " << cd8.at(target) << ")" << std::endl;
+    goal_cost_t gxfm8 = goal(grid, eight, exact, seed, target, maxit, simplex_heuristic_scale<octo_stencil>());
+    std::cout << "A* exact fast marching, 8 neighbors, to (10,10): " << gxfm8.cost << " (" << gxfm8.expanded << " accepted, vs. " << cxfm8.at(target) << ")" << std::endl;
+    std::cout << std::endl;
+
+    work_stealing_pool pool(2);
+    std::vector<point_t> targets{ {10,10}, {-5,5}, {8,-3} };
+    std::vector<path_t> pd8 = paths_on_edge(cd8, targets, pool);
+    std::vector<path_t> pxfm8 = paths_in_simplex(cxfm8, targets, pool);
+    for( size_t t = 0; t < targets.size(); ++t ) {
+        std::cout << "Paths from (" << x(targets[t]) << "," << y(targets[t]) << "): "
+            << path_length(pd8[t]) << " along the Dijkstra parents (" << pd8[t].size() << " points), "
+            << path_length(pxfm8[t]) << " along the exact fast marching gradient (" << pxfm8[t].size() << " points)" << std::endl;
+    }
+    std::cout << std::endl;
+
+    std::vector<query_t> queries{ {{0,0},maxit}, {{10,10},maxit}, {{12,-3},maxit}, {{-5,15},maxit} };
+    std::cout << "Batch of Dijkstra, 8 neighbors" << std::endl;
+    std::vector<costs_t> batch = batch_run(grid, queries, pool, batch_propagation(eight, graph));
+    for( size_t q = 0; q < queries.size(); ++q ) {
+        std::cout << "from (" << x(queries[q].seed) << "," << y(queries[q].seed) << ") to (5,5): " << batch[q].at(make_point(5,5)) << std::endl;
+    }
     std::cout << std::endl;
-    grid_print(cfm8, pmin, pmax, step);
 }
+#endif // ALGOPATTERN_NO_MAIN
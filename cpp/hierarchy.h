@@ -0,0 +1,338 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "code.h"
+
+/** \defgroup Hierarchy Point-to-point queries solved coarse to fine.
+
+    On very large grids, even an A* query (see algo_goal) accepts a number of points
+    growing with the square of the distance to the goal, as soon as the path is not straight.
+    The query is thus first solved on a coarse grid, holding one point every factor points
+    of the fine grid (its step being factor times larger), with the same neighborhood and transit.
+    The coarse path, descended from the goal, then defines a corridor: the coarse points
+    within a given (Chebyshev) radius of the path. The query is finally solved on the fine grid,
+    only through the points whose nearest coarse point is in the corridor,
+    whose costs are the only ones allocated on the fine grid (see corridor_t).
+
+    The fine cost is thus never below the one of the full resolution (on edges),
+    and is equal to it as long as the shortest path stays in the corridor.
+    The obstacles thinner than the coarse step may be missed by the coarse grid:
+    if the goal cannot be reached within the corridor, the whole fine grid is searched.
+
+  @{
+*/
+
+/** The points of a grid within a corridor, indexed compactly.
+
+    The grid is cut in square tiles, and only the tiles holding a point of the corridor are indexed,
+    so that the costs (see corridor_costs) and the front only take memory for them,
+    instead of for the whole grid (or the bounding box of the corridor).
+    The points out of these tiles all share the last index: having no neighbors, they never get a cost.
+    Has the index and point members of grid_t, so that it can index the costs in algo_goal_propagate.
+  */
+class corridor_t
+{
+    public:
+        //! \param side The side of the tiles, in points.
+        corridor_t(const grid_t & grid_, size_t side) :
+            grid(grid_),
+            _side(side),
+            _tiles_x((grid_.width + side - 1) / side),
+            // A copy of npos, which is not defined out of the class.
+            _slots(_tiles_x * ((grid_.height + side - 1) / side), size_t(npos))
+        {
+            assert(side > 0);
+        }
+
+        const grid_t grid;
+
+        //! Add the point (i,j) to the corridor, indexing its tile if needed.
+        void insert(long i, long j)
+        {
+            size_t t = tile(i,j);
+            if( _slots[t] == npos ) {
+                _slots[t] = _tiles.size();
+                _tiles.push_back(t);
+                _inside.resize(_inside.size() + _side * _side, 0);
+            }
+            _inside[index(i,j)] = 1;
+        }
+
+        //! True if the point (i,j) of the grid is in the corridor.
+        bool contains(long i, long j) const
+        {
+            size_t idx = index(i,j);
+            return idx < _inside.size() and _inside[idx];
+        }
+
+        //! Number of indices (including the one shared by the points out of the corridor's tiles).
+        size_t size() const {return _inside.size() + 1;}
+
+        size_t index(long i, long j) const
+        {
+            assert(grid.contains(i,j));
+            size_t slot = _slots[tile(i,j)];
+            if( slot == npos ) {
+                return _inside.size();
+            }
+            const size_t si = static_cast<size_t>(i) % _side;
+            const size_t sj = static_cast<size_t>(j) % _side;
+            return slot * _side * _side + sj * _side + si;
+        }
+        size_t index(const point_t & p) const {return index(grid.i(p), grid.j(p));}
+
+        //! Coordinates of the point at the given index (which should not be the shared one).
+        point_t point(size_t idx) const
+        {
+            assert(idx < _inside.size());
+            const size_t t = _tiles[idx / (_side * _side)];
+            const size_t in = idx % (_side * _side);
+            return grid.point(static_cast<long>((t % _tiles_x) * _side + in % _side),
+                              static_cast<long>((t / _tiles_x) * _side + in / _side));
+        }
+
+        //! Bytes taken by the index.
+        size_t bytes() const {return (_slots.size() + _tiles.size()) * sizeof(size_t) + _inside.size();}
+
+    protected:
+        static const size_t npos = std::numeric_limits<size_t>::max();
+
+        size_t tile(long i, long j) const
+        {
+            return (static_cast<size_t>(j) / _side) * _tiles_x + static_cast<size_t>(i) / _side;
+        }
+
+        const size_t _side;
+        const size_t _tiles_x;
+        //! Index of the tiles in the storage, npos for the ones out of the corridor.
+        std::vector<size_t> _slots;
+        //! The tiles, in the order of the storage.
+        std::vector<size_t> _tiles;
+        //! True for the points of the corridor, in the order of the storage.
+        std::vector<char> _inside;
+};
+
+/** Costs of the points of a corridor (see corridor_t).
+
+    Can be given to the transit functions suffixed by _of, and to algo_goal_propagate, instead of a costs_of.
+  */
+template<typename Real = double>
+class corridor_costs
+{
+    public:
+        corridor_costs(const corridor_t & corridor) : _corridor(corridor), _costs(corridor.size(), std::numeric_limits<Real>::infinity()) {}
+
+        //! The index of the points.
+        const corridor_t & grid() const {return _corridor;}
+        size_t size() const {return _costs.size();}
+
+        Real& operator[](size_t idx)       {assert(idx < _costs.size()); return _costs[idx];}
+        Real  at        (size_t idx) const {assert(idx < _costs.size()); return _costs[idx];}
+
+        Real& operator[](const point_t & p)       {return _costs[_corridor.index(p)];}
+        Real  at        (const point_t & p) const {return _costs[_corridor.index(p)];}
+
+        //! Bytes taken by the costs.
+        size_t bytes() const {return _costs.size() * sizeof(Real);}
+
+    protected:
+        const corridor_t & _corridor;
+        std::vector<Real> _costs;
+};
+
+//! A transit function on the costs of a corridor (e.g. transit_on_edge_of<double,corridor_costs>).
+using corridor_transit_f = std::function< double(const point_t &, const neighbors_t &, const corridor_costs<double> &) >;
+
+//! Cost of a coarse-to-fine query, along with the work done at each resolution.
+struct hierarchy_cost_t
+{
+    double cost;
+    //! Points accepted on the coarse grid.
+    size_t coarse_expanded;
+    //! Points accepted on the fine grid.
+    size_t fine_expanded;
+    //! Points of the fine grid indexed with the corridor (for which costs are allocated).
+    size_t fine_points;
+    //! Bytes taken on the fine grid by the index of the corridor, the costs and the positions in the front.
+    size_t fine_bytes;
+    //! True if the goal was not reached within the corridor, and the whole fine grid has been searched.
+    bool fallback;
+};
+
+/** Compute the cost from the seed to the goal on a coarse grid, then on the fine grid within a corridor around the coarse path.
+
+  \tparam Stencil The neighborhood (see neighbors_grid_if), used at both resolutions.
+  \param grid The fine grid.
+  \param transit The transit function (see algo_goal), on the costs of a corridor.
+  \param factor The number of fine steps in a coarse step (also the side of the fine tiles of the corridor).
+  \param radius The number of coarse points kept on each side of the coarse path.
+  \param passable True for the points which are not obstacles (all of them if empty).
+  \return The cost of the goal (infinite if it cannot be reached), and the number of accepted points.
+*/
+template<typename Stencil = octo_stencil>
+hierarchy_cost_t coarse_to_fine(
+        const grid_t & grid,
+        point_t seed,
+        point_t goal,
+        corridor_transit_f transit,
+        unsigned int factor = 8,
+        unsigned int radius = 2,
+        std::function< bool(const point_t &) > passable = nullptr
+    )
+{
+    assert(factor > 0);
+    hierarchy_cost_t result{std::numeric_limits<double>::infinity(), 0, 0, 0, 0, false};
+    auto free = [&passable] (const point_t & p) {return not passable or passable(p);};
+    // The grids searched as a whole are cut in tiles of this side.
+    const size_t whole_side = 16;
+
+    // Search the part of the given grid indexed in the corridor (nothing, if the start is out of it).
+    auto search = [&] (const corridor_t & corridor, point_t from, point_t to, corridor_costs<double> & costs) -> goal_cost_t {
+        if( not corridor.contains(corridor.grid.i(from), corridor.grid.j(from)) ) {
+            return goal_cost_t{std::numeric_limits<double>::infinity(), 0};
+        }
+        auto neighbors = [&corridor] (const point_t & p) {
+            return neighbors_grid_if<Stencil>(p, corridor.grid, [&corridor] (size_t idx) {
+                std::pair<long,long> c = corridor.grid.coords(idx);
+                return corridor.contains(c.first, c.second);
+            });
+        };
+        front_t front(corridor.size());
+        costs[from] = 0;
+        front.push(corridor.index(from), distance(from, to));
+        return algo_goal_propagate(costs, front, to, corridor.size(), neighbors, transit);
+    };
+    // Index the points of the corridor, the costs and the positions in the front.
+    auto bytes = [] (const corridor_t & corridor, const corridor_costs<double> & costs) {
+        return corridor.bytes() + costs.bytes() + corridor.size() * sizeof(size_t);
+    };
+
+    // The coarse points are the fine points whose (i,j) are multiples of the factor.
+    const long f = static_cast<long>(factor);
+    const long cw = (static_cast<long>(grid.width)  - 1) / f + 1;
+    const long ch = (static_cast<long>(grid.height) - 1) / f + 1;
+    grid_t coarse(grid.pmin, grid.point((cw-1) * f, (ch-1) * f), grid.step * factor);
+    // The coarse point nearest to a fine coordinate.
+    auto ci = [f,cw] (long i) {return std::min((i + f/2) / f, cw-1);};
+    auto cj = [f,ch] (long j) {return std::min((j + f/2) / f, ch-1);};
+    // The range of fine coordinates nearest to a coarse one.
+    auto first = [f] (long c) {return std::max(0L, c*f - f/2);};
+    auto last  = [f] (long c, long n, long size) {return c == n-1 ? size-1 : c*f - f/2 + f-1;};
+
+    corridor_t whole_coarse(coarse, whole_side);
+    for( long j = 0; j < ch; ++j ) {
+        for( long i = 0; i < cw; ++i ) {
+            if( free(coarse.point(i,j)) ) {
+                whole_coarse.insert(i,j);
+            }
+        }
+    }
+    // The passable coarse point nearest to a fine point, in the first ring around its nearest coarse point holding one
+    // (the nearest coarse point itself, if it is passable).
+    auto snap = [&] (const point_t & p) {
+        const long pi = ci(grid.i(p));
+        const long pj = cj(grid.j(p));
+        point_t nearest = coarse.point(pi,pj);
+        double dmin = std::numeric_limits<double>::infinity();
+        for( long r = 0; r < std::max(cw,ch) and dmin == std::numeric_limits<double>::infinity(); ++r ) {
+            for( long j = std::max(0L, pj-r); j <= std::min(ch-1, pj+r); ++j ) {
+                for( long i = std::max(0L, pi-r); i <= std::min(cw-1, pi+r); ++i ) {
+                    if( std::max(std::abs(i-pi), std::abs(j-pj)) == r and whole_coarse.contains(i,j)
+                            and distance(coarse.point(i,j), p) < dmin ) {
+                        nearest = coarse.point(i,j);
+                        dmin = distance(nearest, p);
+                    }
+                }
+            }
+        }
+        return nearest;
+    };
+    point_t cseed = snap(seed);
+    point_t cgoal = snap(goal);
+    corridor_costs<double> ccosts(whole_coarse);
+    goal_cost_t c = search(whole_coarse, cseed, cgoal, ccosts);
+    result.coarse_expanded = c.expanded;
+
+    if( c.cost < std::numeric_limits<double>::infinity() ) {
+        // Descend the coarse costs from the goal, toward the neighbor of least cost, down to the seed.
+        std::vector<point_t> path{cgoal};
+        for( point_t p = cgoal; ccosts.at(p) > 0; p = path.back() ) {
+            point_t next = p;
+            for( const point_t & n : neighbors_grid<Stencil>(p, coarse) ) {
+                if( ccosts.at(n) < ccosts.at(next) ) {
+                    next = n;
+                }
+            }
+            if( next == p ) {
+                break;
+            }
+            path.push_back(next);
+        }
+
+        // Mark the corridor, along with the coarse points nearest to the seed and the goal,
+        // which may be obstacles away from the path.
+        const long r = static_cast<long>(radius);
+        std::vector<bool> corridor(coarse.size(), false);
+        corridor[coarse.index(ci(grid.i(seed)), cj(grid.j(seed)))] = true;
+        corridor[coarse.index(ci(grid.i(goal)), cj(grid.j(goal)))] = true;
+        for( const point_t & p : path ) {
+            const long pi = coarse.i(p);
+            const long pj = coarse.j(p);
+            for( long j = std::max(0L, pj-r); j <= std::min(ch-1, pj+r); ++j ) {
+                for( long i = std::max(0L, pi-r); i <= std::min(cw-1, pi+r); ++i ) {
+                    corridor[coarse.index(i,j)] = true;
+                }
+            }
+        }
+
+        // The passable fine points nearest to the coarse points of the corridor.
+        const long W = static_cast<long>(grid.width);
+        const long H = static_cast<long>(grid.height);
+        corridor_t fine(grid, factor);
+        for( long j = 0; j < ch; ++j ) {
+            for( long i = 0; i < cw; ++i ) {
+                if( corridor[coarse.index(i,j)] ) {
+                    for( long fj = first(j); fj <= last(j,ch,H); ++fj ) {
+                        for( long fi = first(i); fi <= last(i,cw,W); ++fi ) {
+                            if( free(grid.point(fi,fj)) ) {
+                                fine.insert(fi,fj);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        corridor_costs<double> fcosts(fine);
+        goal_cost_t g = search(fine, seed, goal, fcosts);
+        result.cost = g.cost;
+        result.fine_expanded = g.expanded;
+        result.fine_points = fine.size();
+        result.fine_bytes = bytes(fine, fcosts);
+    }
+
+    if( result.cost == std::numeric_limits<double>::infinity() ) {
+        result.fallback = true;
+        corridor_t whole(grid, whole_side);
+        for( long j = 0; j < static_cast<long>(grid.height); ++j ) {
+            for( long i = 0; i < static_cast<long>(grid.width); ++i ) {
+                if( free(grid.point(i,j)) ) {
+                    whole.insert(i,j);
+                }
+            }
+        }
+        corridor_costs<double> costs(whole);
+        goal_cost_t g = search(whole, seed, goal, costs);
+        result.cost = g.cost;
+        result.fine_expanded += g.expanded;
+        result.fine_points = whole.size();
+        result.fine_bytes = bytes(whole, costs);
+    }
+    return result;
+}
+
+/** @} Hierarchy */
@@ -0,0 +1,666 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <set>
+#include <bitset>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+#include "code.h"
+
+/** \defgroup NDim Grids of any dimension.
+
+    The same two operator slots (neighborhood and Hopf-Lax operator) on regular grids
+    of a dimension D given at compile time, e.g. 3D volumes:
+
+    - points are fixed-size arrays of D coordinates,
+    - costs are stored densely, in a contiguous array addressed by a flat index
+      in which the first coordinate varies the fastest (like the row-major index of grid_t),
+    - a neighborhood is a stencil of integer displacements, along with the simplexes
+      which triangulate the surface around the considered point,
+    - the Hopf-Lax operators either walk on the edges toward the neighbors (Dijkstra),
+      or solve the exact transit across the simplexes (Fast-Marching, with tetrahedral updates in 3D).
+
+    Three stencils are provided: the 2D axis neighbors (6 in 3D, see axis_stencil),
+    the neighbors sharing an edge (18 in 3D, see edge_stencil)
+    and the whole surrounding cube (3^D-1 neighbors, 26 in 3D, see cube_stencil).
+    In 2D, the axis and cube stencils are the 4 and 8 neighbors of quad_stencil and octo_stencil.
+    The policies composition runs them through the same algo class,
+    with the neighbors::axis_grid_n and neighbors::cube_grid_n policies.
+
+  @{
+*/
+
+template<size_t D>
+using point_n = std::array<double,D>;
+//! Integer coordinates of a grid point.
+template<size_t D>
+using coords_n = std::array<long,D>;
+//! Integer displacement on a grid, in number of steps along each axis.
+template<size_t D>
+using offset_n = std::array<int,D>;
+
+//! Euclidean distance.
+template<size_t D>
+double distance(const point_n<D> & u, const point_n<D> & v)
+{
+    double d2 = 0;
+    for( size_t k = 0; k < D; ++k ) {
+        d2 += (u[k]-v[k]) * (u[k]-v[k]);
+    }
+    return std::sqrt(d2);
+}
+
+/** A regular grid of dimension D, defined by a box and an orthogonal step size.
+
+    Same as grid_t, the first coordinate being the fastest varying one in the flat index.
+  */
+template<size_t D>
+class grid_n
+{
+    public:
+        grid_n(const point_n<D> & pmin_, const point_n<D> & pmax_, double step_)
+            : pmin(pmin_), pmax(pmax_), step(step_)
+        {
+            assert(step > 0);
+            size_t stride = 1;
+            for( size_t k = 0; k < D; ++k ) {
+                assert(pmin[k] <= pmax[k]);
+                // The small tolerance avoids losing the last line
+                // if the extent is not an exact multiple of the step.
+                extents[k] = static_cast<size_t>(std::floor((pmax[k]-pmin[k]) / step + 1e-6)) + 1;
+                strides[k] = stride;
+                stride *= extents[k];
+            }
+        }
+
+        //! Number of points of the grid.
+        size_t size() const {return strides[D-1] * extents[D-1];}
+
+        //! Integer coordinates of the grid point nearest to p.
+        coords_n<D> coords(const point_n<D> & p) const
+        {
+            coords_n<D> c;
+            for( size_t k = 0; k < D; ++k ) {
+                c[k] = std::lround( (p[k]-pmin[k]) / step );
+            }
+            return c;
+        }
+
+        //! Integer coordinates of the grid point at the given flat index.
+        coords_n<D> coords(size_t idx) const
+        {
+            coords_n<D> c;
+            for( size_t k = 0; k < D; ++k ) {
+                c[k] = static_cast<long>(idx % extents[k]);
+                idx /= extents[k];
+            }
+            return c;
+        }
+
+        bool contains(const coords_n<D> & c) const
+        {
+            for( size_t k = 0; k < D; ++k ) {
+                if( c[k] < 0 or c[k] >= static_cast<long>(extents[k]) ) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        //! Flat index of the grid point at the given coordinates.
+        size_t index(const coords_n<D> & c) const
+        {
+            assert(contains(c));
+            size_t idx = 0;
+            for( size_t k = 0; k < D; ++k ) {
+                idx += static_cast<size_t>(c[k]) * strides[k];
+            }
+            return idx;
+        }
+        size_t index(const point_n<D> & p) const {return index(coords(p));}
+
+        //! Coordinates of the grid point at the given integer coordinates.
+        point_n<D> point(const coords_n<D> & c) const
+        {
+            point_n<D> p;
+            for( size_t k = 0; k < D; ++k ) {
+                p[k] = pmin[k] + c[k] * step;
+            }
+            return p;
+        }
+        point_n<D> point(size_t idx) const {return point(coords(idx));}
+
+        point_n<D> pmin;
+        point_n<D> pmax;
+        double step;
+        //! Number of points along each axis.
+        std::array<size_t,D> extents;
+        //! Difference of flat index between two consecutive points along each axis.
+        std::array<size_t,D> strides;
+};
+
+/** Time to go to each point of a grid of dimension D.
+
+    Same as costs_t: a dense contiguous storage, in which a point without cost holds an infinite cost.
+    A 512³ volume thus takes 1 GiB of costs.
+  */
+template<size_t D>
+class costs_n
+{
+    public:
+        costs_n(const grid_n<D> & grid_) : _grid(grid_), _costs(grid_.size(), std::numeric_limits<double>::infinity()) {}
+
+        const grid_n<D> & grid() const {return _grid;}
+        size_t size() const {return _costs.size();}
+
+        //! Remove all the costs.
+        void reset() {std::fill(begin(_costs), end(_costs), std::numeric_limits<double>::infinity());}
+
+        double& operator[](size_t idx)       {assert(idx < _costs.size()); return _costs[idx];}
+        double  at        (size_t idx) const {assert(idx < _costs.size()); return _costs[idx];}
+
+        double& operator[](const point_n<D> & p)       {return _costs[_grid.index(p)];}
+        double  at        (const point_n<D> & p) const {return _costs[_grid.index(p)];}
+
+        //! The contiguous costs, in the grid's index order.
+        const double* data() const {return _costs.data();}
+
+    protected:
+        grid_n<D> _grid;
+        std::vector<double> _costs;
+};
+
+//! 3^d, the number of points of the cube surrounding a point (itself included).
+constexpr size_t pow3(size_t d) {return d == 0 ? 1 : 3 * pow3(d-1);}
+
+/** Integer displacements toward the neighbors, along with the simplexes formed by the neighbors.
+
+    Each simplex is given by the D ranks of its vertices in the offsets,
+    and the simplexes should cover the whole surface around the origin, without overlapping.
+    The geometry of each face of the simplexes (vertices, edges, triangles, …) is precomputed,
+    so that the exact transit across a face only depends on the costs of its vertices
+    (see transit_in_simplex_n).
+  */
+template<size_t D>
+class stencil_n
+{
+    public:
+        //! The most neighbors a stencil can have: all the points of the surrounding cube.
+        static constexpr size_t capacity = pow3(D) - 1;
+
+        /** A face of a simplex, i.e. a subset of its vertices.
+
+            With the vectors v_i from the origin toward the vertices, in steps,
+            the last vertex k, and E the matrix of the edges (v_i - v_k),
+            this holds the inverse of the Gram matrix G = E^T E,
+            the coordinates b = G^-1 E^T v_k of the projection of v_k on the edges,
+            and the distance from the origin to the affine hull of the face. */
+        struct face_t
+        {
+            size_t size;
+            std::array<size_t,D> ranks;
+            std::array<double,(D-1)*(D-1)> ginv;
+            std::array<double,D-1> b;
+            double height;
+            //! The ranks of the vertices, as a set.
+            std::bitset<capacity> mask;
+        };
+
+        stencil_n(const std::vector< offset_n<D> > & offsets, const std::vector< std::array<size_t,D> > & simplexes)
+            : _offsets(offsets)
+        {
+            assert(_offsets.size() <= capacity);
+            for( const offset_n<D> & o : _offsets ) {
+                double l2 = 0;
+                for( size_t k = 0; k < D; ++k ) {
+                    l2 += o[k] * o[k];
+                }
+                _lengths.push_back(std::sqrt(l2));
+            }
+            // Faces shared by several simplexes are only solved once.
+            std::set< std::vector<size_t> > faces;
+            for( const auto & simplex : simplexes ) {
+                for( size_t mask = 1; mask < (1U << D); ++mask ) {
+                    std::vector<size_t> face;
+                    for( size_t i = 0; i < D; ++i ) {
+                        if( mask & (1U << i) ) {
+                            assert(simplex[i] < _offsets.size());
+                            face.push_back(simplex[i]);
+                        }
+                    }
+                    std::sort(face.begin(), face.end());
+                    faces.insert(face);
+                }
+            }
+            for( const auto & face : faces ) {
+                _faces.push_back(make_face(face));
+            }
+            // Vertices first, so that their costs bound the transits across the larger faces.
+            std::stable_sort(_faces.begin(), _faces.end(), [](const face_t & a, const face_t & b) {return a.size < b.size;});
+        }
+
+        size_t size() const {return _offsets.size();}
+        const offset_n<D> & offset(size_t rank) const {return _offsets[rank];}
+        //! The distance toward a neighbor, in steps.
+        double length(size_t rank) const {return _lengths[rank];}
+        const std::vector<face_t> & faces() const {return _faces;}
+
+    protected:
+        face_t make_face(const std::vector<size_t> & ranks) const
+        {
+            face_t f;
+            f.size = ranks.size();
+            std::copy(ranks.begin(), ranks.end(), f.ranks.begin());
+            for( size_t r : ranks ) {
+                f.mask.set(r);
+            }
+            const size_t m = f.size - 1;
+            const offset_n<D> & vk = _offsets[ranks[m]];
+
+            // Edges, Gram matrix (augmented with the identity, for the inversion) and E^T v_k.
+            std::vector< std::array<double,D> > e(m);
+            for( size_t i = 0; i < m; ++i ) {
+                for( size_t k = 0; k < D; ++k ) {
+                    e[i][k] = _offsets[ranks[i]][k] - vk[k];
+                }
+            }
+            std::vector< std::vector<double> > g(m, std::vector<double>(2*m, 0));
+            std::vector<double> etv(m, 0);
+            for( size_t i = 0; i < m; ++i ) {
+                for( size_t j = 0; j < m; ++j ) {
+                    for( size_t k = 0; k < D; ++k ) {
+                        g[i][j] += e[i][k] * e[j][k];
+                    }
+                }
+                g[i][m+i] = 1;
+                for( size_t k = 0; k < D; ++k ) {
+                    etv[i] += e[i][k] * vk[k];
+                }
+            }
+            // Gauss-Jordan elimination, the Gram matrix of independent edges is positive definite.
+            for( size_t i = 0; i < m; ++i ) {
+                assert(g[i][i] > 0);
+                double pivot = g[i][i];
+                for( size_t j = 0; j < 2*m; ++j ) {
+                    g[i][j] /= pivot;
+                }
+                for( size_t r = 0; r < m; ++r ) {
+                    if( r != i ) {
+                        double factor = g[r][i];
+                        for( size_t j = 0; j < 2*m; ++j ) {
+                            g[r][j] -= factor * g[i][j];
+                        }
+                    }
+                }
+            }
+            for( size_t i = 0; i < m; ++i ) {
+                f.b[i] = 0;
+                for( size_t j = 0; j < m; ++j ) {
+                    f.ginv[i*(D-1)+j] = g[i][m+j];
+                    f.b[i] += g[i][m+j] * etv[j];
+                }
+            }
+            // The component of v_k orthogonal to the edges.
+            double h2 = 0;
+            for( size_t k = 0; k < D; ++k ) {
+                double w = vk[k];
+                for( size_t i = 0; i < m; ++i ) {
+                    w -= e[i][k] * f.b[i];
+                }
+                h2 += w * w;
+            }
+            f.height = std::sqrt(h2);
+            assert(f.height > 0);
+            return f;
+        }
+
+        std::vector< offset_n<D> > _offsets;
+        std::vector<double> _lengths;
+        std::vector<face_t> _faces;
+};
+template<size_t D>
+constexpr size_t stencil_n<D>::capacity;
+
+/** The 2D neighbors along the axes (4 in 2D, 6 in 3D).
+
+    The simplexes are the 2^D orthants, each one formed by a single neighbor along each axis.
+ */
+template<size_t D>
+stencil_n<D> axis_stencil()
+{
+    std::vector< offset_n<D> > offsets;
+    for( size_t k = 0; k < D; ++k ) {
+        for( int s : {1, -1} ) {
+            offset_n<D> o{};
+            o[k] = s;
+            offsets.push_back(o);
+        }
+    }
+    std::vector< std::array<size_t,D> > simplexes;
+    for( size_t orthant = 0; orthant < (1U << D); ++orthant ) {
+        std::array<size_t,D> simplex;
+        for( size_t k = 0; k < D; ++k ) {
+            // Rank of +e_k is 2k, rank of -e_k is 2k+1.
+            simplex[k] = 2*k + ((orthant >> k) & 1);
+        }
+        simplexes.push_back(simplex);
+    }
+    return stencil_n<D>(offsets, simplexes);
+}
+
+/** All the points of the cube surrounding the origin (8 in 2D, 26 in 3D).
+
+    Each facet of the cube is cut in unit hypercubes, themselves cut in simplexes
+    going from the center of the facet toward the corners of the cube, one axis at a time
+    (i.e. the Kuhn triangulation, which gives 48 tetrahedra in 3D).
+ */
+template<size_t D>
+stencil_n<D> cube_stencil()
+{
+    std::vector< offset_n<D> > offsets;
+    for( size_t c = 0; c < pow3(D); ++c ) {
+        offset_n<D> o;
+        bool origin = true;
+        for( size_t k = 0, r = c; k < D; ++k, r /= 3 ) {
+            o[k] = static_cast<int>(r % 3) - 1;
+            origin &= o[k] == 0;
+        }
+        if( not origin ) {
+            offsets.push_back(o);
+        }
+    }
+    auto rank = [&offsets] (const offset_n<D> & o) {
+        return static_cast<size_t>(std::find(offsets.begin(), offsets.end(), o) - offsets.begin());
+    };
+
+    std::vector< std::array<size_t,D> > simplexes;
+    for( size_t axis = 0; axis < D; ++axis ) {
+        std::vector<size_t> free;
+        for( size_t k = 0; k < D; ++k ) {
+            if( k != axis ) {
+                free.push_back(k);
+            }
+        }
+        for( int s : {1, -1} ) {
+            // Each unit hypercube of the facet is given by the signs of its free axes.
+            for( size_t signs = 0; signs < (1U << (D-1)); ++signs ) {
+                std::vector<size_t> order(free);
+                do {
+                    offset_n<D> o{};
+                    o[axis] = s;
+                    std::array<size_t,D> simplex;
+                    simplex[0] = rank(o);
+                    for( size_t i = 0; i+1 < D; ++i ) {
+                        size_t k = order[i];
+                        size_t f = static_cast<size_t>(std::find(free.begin(), free.end(), k) - free.begin());
+                        o[k] = ((signs >> f) & 1) ? -1 : 1;
+                        simplex[i+1] = rank(o);
+                    }
+                    simplexes.push_back(simplex);
+                } while( std::next_permutation(order.begin(), order.end()) );
+            }
+        }
+    }
+    return stencil_n<D>(offsets, simplexes);
+}
+
+/** The 18 neighbors sharing at least an edge with the voxel of the origin, in 3D.
+
+    The surface they form is the cube with cut corners:
+    each facet is cut in four triangles around its center,
+    and each corner is cut by a triangle.
+ */
+inline stencil_n<3> edge_stencil()
+{
+    std::vector< offset_n<3> > offsets;
+    for( int i = -1; i <= 1; ++i ) {
+        for( int j = -1; j <= 1; ++j ) {
+            for( int k = -1; k <= 1; ++k ) {
+                int nonzero = (i != 0) + (j != 0) + (k != 0);
+                if( nonzero == 1 or nonzero == 2 ) {
+                    offsets.push_back({i,j,k});
+                }
+            }
+        }
+    }
+    auto rank = [&offsets] (const offset_n<3> & o) {
+        return static_cast<size_t>(std::find(offsets.begin(), offsets.end(), o) - offsets.begin());
+    };
+
+    std::vector< std::array<size_t,3> > simplexes;
+    for( size_t axis = 0; axis < 3; ++axis ) {
+        size_t b = (axis + 1) % 3;
+        size_t c = (axis + 2) % 3;
+        for( int s : {1, -1} ) {
+            offset_n<3> center{};
+            center[axis] = s;
+            for( int t : {1, -1} ) {
+                for( int u : {1, -1} ) {
+                    offset_n<3> ob(center), oc(center);
+                    ob[b] = t;
+                    oc[c] = u;
+                    simplexes.push_back({rank(center), rank(ob), rank(oc)});
+                }
+            }
+        }
+    }
+    for( int i : {1, -1} ) {
+        for( int j : {1, -1} ) {
+            for( int k : {1, -1} ) {
+                simplexes.push_back({rank({i,j,0}), rank({i,0,k}), rank({0,j,k})});
+            }
+        }
+    }
+    return stencil_n<3>(offsets, simplexes);
+}
+
+/** The neighbors of a point on a grid of dimension D.
+
+    Neighbors are given by their flat index, in the order of the stencil's offsets,
+    and the ones outside of the grid are marked by npos.
+  */
+template<size_t D>
+struct neighbors_n
+{
+    static const size_t npos = std::numeric_limits<size_t>::max();
+
+    const stencil_n<D> * stencil;
+    std::array<size_t, stencil_n<D>::capacity> index;
+};
+template<size_t D>
+const size_t neighbors_n<D>::npos;
+
+/** Compute the neighbors of the given point, according to the grid and the stencil. */
+template<size_t D>
+neighbors_n<D> neighbors_grid_n(const point_n<D> & p, const grid_n<D> & grid, const stencil_n<D> & stencil)
+{
+    neighbors_n<D> neighbors;
+    neighbors.stencil = &stencil;
+    const coords_n<D> c = grid.coords(p);
+    const size_t idx = grid.index(c);
+    for( size_t r = 0; r < stencil.size(); ++r ) {
+        const offset_n<D> & o = stencil.offset(r);
+        bool inside = true;
+        size_t in = idx;
+        for( size_t k = 0; k < D; ++k ) {
+            long ck = c[k] + o[k];
+            inside &= 0 <= ck and ck < static_cast<long>(grid.extents[k]);
+            // Wraps around if outside, but is then discarded.
+            in += static_cast<size_t>(static_cast<long>(grid.strides[k]) * o[k]);
+        }
+        neighbors.index[r] = inside ? in : neighbors_n<D>::npos;
+    }
+    return neighbors;
+}
+
+/** Find the transit of minimal cost among the edges toward the neighbors, at the given slowness. */
+template<size_t D>
+double transit_on_edge_n_weighted(const point_n<D> &, const neighbors_n<D> & neighbors, const costs_n<D> & costs, double slowness)
+{
+    const double step = slowness * costs.grid().step;
+    double mincost = std::numeric_limits<double>::infinity();
+    for( size_t r = 0; r < neighbors.stencil->size(); ++r ) {
+        size_t in = neighbors.index[r];
+        if( in != neighbors_n<D>::npos ) {
+            // Infinite for the points without cost.
+            mincost = std::min(mincost, costs.at(in) + step * neighbors.stencil->length(r));
+        }
+    }
+    // Should be near the front (and thus have found a transit).
+    assert(mincost != std::numeric_limits<double>::infinity());
+    return mincost;
+}
+
+/** Find the transit of minimal cost among the edges toward the neighbors, at unit speed. */
+template<size_t D>
+double transit_on_edge_n(const point_n<D> & p, const neighbors_n<D> & neighbors, const costs_n<D> & costs)
+{
+    return transit_on_edge_n_weighted(p, neighbors, costs, 1);
+}
+
+/** Find the exact transit of minimal cost across the simplexes of the neighbors, at the given slowness.
+
+    The costs are linearly interpolated on each simplex, and the transit is minimized in closed form
+    on each face having costs on all its vertices: the minimum over a simplex is either at the stationary point
+    within one of its faces, or at one of its vertices.
+    In 2D, this is transit_in_simplex_exact (see transit_across_edge),
+    and in 3D, the tetrahedral update of the Fast Marching method.
+  */
+template<size_t D>
+double transit_in_simplex_n_weighted(const point_n<D> &, const neighbors_n<D> & neighbors, const costs_n<D> & costs, double slowness)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    // Costs are normalized by the time to travel a step, in which the faces are precomputed.
+    const double unit = slowness * costs.grid().step;
+    const stencil_n<D> & stencil = *neighbors.stencil;
+    double mincost = inf;
+
+    // The neighbors having a cost, which is looked up only once.
+    std::array<double, stencil_n<D>::capacity> costs_of;
+    std::bitset<stencil_n<D>::capacity> reached;
+    for( size_t r = 0; r < stencil.size(); ++r ) {
+        size_t in = neighbors.index[r];
+        if( in != neighbors_n<D>::npos and costs.at(in) < inf ) {
+            costs_of[r] = costs.at(in) / unit;
+            reached.set(r);
+        }
+    }
+
+    for( const auto & f : stencil.faces() ) {
+        if( (f.mask & ~reached).any() ) {
+            continue;
+        }
+        std::array<double,D> c{};
+        double lowest = inf;
+        for( size_t i = 0; i < f.size; ++i ) {
+            c[i] = costs_of[f.ranks[i]];
+            lowest = std::min(lowest, c[i]);
+        }
+        // The transit cannot be lower than the lowest cost plus the distance to the face.
+        if( lowest + f.height >= mincost ) {
+            continue;
+        }
+        const size_t m = f.size - 1;
+        if( m == 0 ) {
+            mincost = std::min(mincost, c[0] + stencil.length(f.ranks[0]));
+            continue;
+        }
+        // Differences of costs with the last vertex, and their norm in the metric of the edges.
+        std::array<double,D-1> d, gd;
+        double q = 0;
+        for( size_t i = 0; i < m; ++i ) {
+            d[i] = c[i] - c[m];
+        }
+        for( size_t i = 0; i < m; ++i ) {
+            gd[i] = 0;
+            for( size_t j = 0; j < m; ++j ) {
+                gd[i] += f.ginv[i*(D-1)+j] * d[j];
+            }
+            q += d[i] * gd[i];
+        }
+        // The front would travel faster than unit speed along the face.
+        if( q >= 1 ) {
+            continue;
+        }
+        double r = f.height / std::sqrt(1 - q);
+        // Barycentric coordinates of the stationary point (the last one being one minus their sum).
+        double sum = 0;
+        double cost = c[m] + r;
+        bool inside = true;
+        for( size_t i = 0; i < m; ++i ) {
+            double mu = -(f.b[i] + r * gd[i]);
+            inside &= mu > 0;
+            sum += mu;
+            cost += mu * d[i];
+        }
+        if( inside and sum < 1 ) {
+            mincost = std::min(mincost, cost);
+        }
+    }
+    // Should be near the front (and thus have found a transit).
+    assert(mincost < inf);
+    return unit * mincost;
+}
+
+/** Find the exact transit of minimal cost across the simplexes of the neighbors, at unit speed. */
+template<size_t D>
+double transit_in_simplex_n(const point_n<D> & p, const neighbors_n<D> & neighbors, const costs_n<D> & costs)
+{
+    return transit_in_simplex_n_weighted(p, neighbors, costs, 1);
+}
+
+/** Propagate the given front, during the given number of iterations.
+
+  Same as algo_propagate, on a grid of dimension D.
+
+  \tparam Front A front which can be built from the number of points (see heap_front).
+  \param neighbors A function returning the neighbors_n of a point.
+  \param transit A function returning the transit of a point, from its neighbors and the costs.
+*/
+template<typename Front, size_t D, typename N, typename T>
+void algo_propagate_n(costs_n<D> & costs, Front & front, size_t iterations, N & neighbors, T & transit)
+{
+    const grid_n<D> & grid = costs.grid();
+    const double inf = std::numeric_limits<double>::infinity();
+
+    size_t i = 0;
+    while(i++ < iterations and not front.empty()) {
+        // Accept the node with the min cost and update neighbors.
+        size_t ia = front.pop();
+        neighbors_n<D> around = neighbors(grid.point(ia));
+        for( size_t r = 0; r < around.stencil->size(); ++r ) {
+            size_t in = around.index[r];
+            // If the node exists, and has not been accepted yet.
+            if( in != neighbors_n<D>::npos and (costs[in] == inf or front.contains(in)) ) {
+                point_n<D> n = grid.point(in);
+                double c = transit(n, neighbors(n), costs);
+                if( c < costs[in] ) {
+                    costs[in] = c;
+                    front.update(in, c);
+                }
+            }
+        }
+    }
+}
+
+/** Propagate the front from the given seed, on a grid of dimension D.
+
+  \param iterations The maximum number of iterations.
+  \return The costs on the grid.
+*/
+template<typename Front = front_t, size_t D, typename N, typename T>
+costs_n<D> algo_run_n(const grid_n<D> & grid, const point_n<D> & seed, size_t iterations, N neighbors, T transit)
+{
+    costs_n<D> costs(grid);
+    Front front(grid.size());
+    costs[seed] = 0;
+    front.push(grid.index(seed), 0);
+    algo_propagate_n(costs, front, iterations, neighbors, transit);
+    return costs;
+}
+
+/** @} NDim */
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "code.h"
+
+/** \defgroup Output Binary output of the costs.
+
+    Instead of pretty printing (see grid_print), the costs can be written as binary values,
+    either float32 or float64, in row-major order (i.e. rows of increasing y, each of increasing x, whatever the layout of the grid):
+    - raw: a small header (see costs_header_t) followed by the values,
+    - npy: the NumPy format, with a (height, width) shape, that numpy.load can map.
+    Points without cost hold an infinite value.
+    Values are written in the native byte order, which the npy header supposes to be little-endian.
+    Any costs store having contiguous costs can be written (e.g. a costs_of<float>, or the touched_costs of a workspace).
+
+    The values are converted and written by chunks of rows, so that the output is I/O bound.
+    They can also be copied directly into a caller-supplied buffer (e.g. a memory-mapped file),
+    of costs_bytes() bytes.
+
+  @{
+*/
+
+enum class costs_format_t { raw, npy };
+
+//! Header of a raw costs file.
+struct costs_header_t
+{
+    char magic[8];
+    uint32_t width;
+    uint32_t height;
+};
+
+//! Identification of the scalar types in the headers.
+template<typename T>
+struct scalar_traits;
+
+template<>
+struct scalar_traits<float>
+{
+    static const char* raw_magic() {return "ALGOCF32";}
+    static const char* npy_descr() {return "<f4";}
+};
+
+template<>
+struct scalar_traits<double>
+{
+    static const char* raw_magic() {return "ALGOCF64";}
+    static const char* npy_descr() {return "<f8";}
+};
+
+//! The header of a costs file, in the given format.
+template<typename T>
+std::string costs_header(const grid_t & grid, costs_format_t format)
+{
+    static_assert(sizeof(T) == 4 or sizeof(T) == 8, "only float32 and float64 are supported");
+    if( format == costs_format_t::raw ) {
+        costs_header_t header;
+        std::memcpy(header.magic, scalar_traits<T>::raw_magic(), sizeof(header.magic));
+        header.width = static_cast<uint32_t>(grid.width);
+        header.height = static_cast<uint32_t>(grid.height);
+        return std::string(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    // NPY version 1.0: magic, version, little-endian length of the dictionary,
+    // padded with spaces and ending with a newline, so that the data is 64-bytes aligned.
+    std::ostringstream dict;
+    dict << "{'descr': '" << scalar_traits<T>::npy_descr() << "', 'fortran_order': False, 'shape': ("
+         << grid.height << ", " << grid.width << "), }";
+    std::string d = dict.str();
+    const size_t prefix = 10;
+    size_t total = prefix + d.size() + 1;
+    total = (total + 63) / 64 * 64;
+    d.append(total - prefix - d.size() - 1, ' ');
+    d.push_back('\n');
+
+    std::string header("\x93NUMPY\x01\x00", 8);
+    header.push_back(static_cast<char>(d.size() & 0xff));
+    header.push_back(static_cast<char>(d.size() >> 8));
+    return header + d;
+}
+
+//! The size of a costs file, header included.
+template<typename T>
+size_t costs_bytes(const grid_t & grid, costs_format_t format)
+{
+    return costs_header<T>(grid, format).size() + grid.width * grid.height * sizeof(T);
+}
+
+/** Convert the given rows of costs, in row-major order, whatever the layout of the grid. */
+template<typename T, typename Real, template<typename> class Costs>
+void costs_rows(const Costs<Real> & costs, size_t first_row, size_t rows, T* dest)
+{
+    const grid_t & grid = costs.grid();
+    if( grid.layout == layout_t::row_major ) {
+        const Real* row = costs.data() + first_row * grid.width;
+        std::copy(row, row + rows * grid.width, dest);
+    } else {
+        for( size_t j = first_row; j < first_row + rows; ++j ) {
+            for( size_t i = 0; i < grid.width; ++i ) {
+                *dest++ = static_cast<T>(costs.at(grid.index(i,j)));
+            }
+        }
+    }
+}
+
+/** Write the costs on the given stream, converted by chunks of rows.
+
+    \param chunk_rows The number of rows converted at once. If null, chunks are about 1 MiB.
+*/
+template<typename T = float, typename Real, template<typename> class Costs>
+void costs_write(const Costs<Real> & costs, std::ostream & out, costs_format_t format = costs_format_t::npy, size_t chunk_rows = 0)
+{
+    const grid_t & grid = costs.grid();
+    std::string header = costs_header<T>(grid, format);
+    out.write(header.data(), header.size());
+
+    if( chunk_rows == 0 ) {
+        chunk_rows = std::max<size_t>(1, (1 << 20) / (grid.width * sizeof(T)));
+    }
+    std::vector<T> buffer(chunk_rows * grid.width);
+    for( size_t j = 0; j < grid.height; j += chunk_rows ) {
+        size_t n = std::min(chunk_rows, grid.height - j) * grid.width;
+        costs_rows(costs, j, n / grid.width, buffer.data());
+        out.write(reinterpret_cast<const char*>(buffer.data()), n * sizeof(T));
+    }
+}
+
+//! Write the costs in the file at the given path.
+template<typename T = float, typename Real, template<typename> class Costs>
+void costs_write(const Costs<Real> & costs, const std::string & path, costs_format_t format = costs_format_t::npy)
+{
+    std::ofstream out(path, std::ios::binary);
+    costs_write<T>(costs, out, format);
+    out.flush();
+    if( not out ) {
+        throw std::runtime_error("cannot write costs: " + path);
+    }
+}
+
+/** Copy the costs file into the given buffer, of at least costs_bytes() bytes.
+
+    The buffer should be aligned on T (memory-mapped files are aligned on pages).
+    \return The end of the copied bytes.
+*/
+template<typename T = float, typename Real, template<typename> class Costs>
+char* costs_copy(const Costs<Real> & costs, char* dest, costs_format_t format = costs_format_t::npy)
+{
+    std::string header = costs_header<T>(costs.grid(), format);
+    std::memcpy(dest, header.data(), header.size());
+    char* data = dest + header.size();
+    assert(reinterpret_cast<uintptr_t>(data) % alignof(T) == 0);
+    T* values = reinterpret_cast<T*>(data);
+    const grid_t & grid = costs.grid();
+    costs_rows(costs, 0, grid.height, values);
+    return data + grid.width * grid.height * sizeof(T);
+}
+
+/** @} Output */
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+
+#include "code.h"
+#include "pool.h"
+
+/** \defgroup Paths Extraction of the shortest paths from computed costs.
+
+    Once the costs from the seeds are computed, the shortest path from any target point
+    is found by descending the costs, down to a seed:
+
+    - for costs computed on edges (Dijkstra), the path follows the discrete parent pointers,
+      which are computed once for the whole grid (see paths_parents),
+    - for costs computed in simplexes (fast marching), the path follows the gradient
+      of the bilinear interpolation of the costs, and thus may cut across the cells.
+
+    Extracting a path only reads the costs (and the parents), so that as many paths as needed
+    can be extracted concurrently from the same field, without copying it (see paths_run).
+
+  @{
+*/
+
+//! The points of a path, from its target to a seed.
+using path_t = std::vector<point_t>;
+
+//! The index of the parent of each point of a grid.
+using parents_t = std::vector<size_t>;
+
+//! The parent of the points without costs, and of the seeds.
+const size_t no_parent = std::numeric_limits<size_t>::max();
+
+/** The neighbor from which the cost of the given point comes, or no_parent.
+
+    This is the neighbor toward which the costs descend the steepest,
+    i.e. the one maximizing (c(p) - c(n)) / distance(p,n).
+    For costs computed on edges, whatever the slowness around p,
+    it is the neighbor whose transit gave the cost of p.
+
+  \tparam Stencil The integer displacements toward the neighbors.
+ */
+template<typename Stencil = octo_stencil>
+size_t parent_of(const costs_t & costs, size_t idx)
+{
+    const grid_t & grid = costs.grid();
+    const double c = costs.at(idx);
+    if( c == std::numeric_limits<double>::infinity() ) {
+        return no_parent;
+    }
+    const std::pair<long,long> ij = grid.coords(idx);
+    const long i = ij.first;
+    const long j = ij.second;
+    size_t parent = no_parent;
+    double steepest = 0;
+    for( size_t d = 0; d < Stencil::size; ++d) {
+        long ni = i + Stencil::xy[2*d];
+        long nj = j + Stencil::xy[2*d+1];
+        if( grid.contains(ni,nj) ) {
+            size_t in = grid.index(ni,nj);
+            // Costs only descend strictly, hence the paths cannot loop.
+            double slope = (c - costs.at(in)) / std::sqrt(Stencil::xy[2*d]*Stencil::xy[2*d] + Stencil::xy[2*d+1]*Stencil::xy[2*d+1]);
+            if( slope > steepest ) {
+                steepest = slope;
+                parent = in;
+            }
+        }
+    }
+    return parent;
+}
+
+/** Compute the parents of all the points of the grid, in parallel on the given pool.
+
+    \param chunk The number of points computed by each task of the pool.
+ */
+template<typename Stencil = octo_stencil>
+parents_t paths_parents(const costs_t & costs, work_stealing_pool & pool, size_t chunk = 1 << 14)
+{
+    parents_t parents(costs.size(), no_parent);
+    for( size_t first = 0; first < costs.size(); first += chunk ) {
+        pool.submit( [&costs,&parents,first,chunk] (unsigned int) {
+            size_t last = std::min(first + chunk, costs.size());
+            for( size_t idx = first; idx < last; ++idx ) {
+                parents[idx] = parent_of<Stencil>(costs, idx);
+            }
+        });
+    }
+    pool.wait();
+    return parents;
+}
+
+/** Follow the parents from the given target, up to a seed.
+
+  \return The grid points of the path, or an empty path if the target has no cost.
+ */
+inline path_t path_parents(const parents_t & parents, const costs_t & costs, const point_t & target)
+{
+    const grid_t & grid = costs.grid();
+    assert(parents.size() == grid.size());
+    path_t path;
+    size_t idx = grid.index(target);
+    if( costs.at(idx) == std::numeric_limits<double>::infinity() ) {
+        return path;
+    }
+    path.push_back(grid.point(idx));
+    while( parents[idx] != no_parent ) {
+        idx = parents[idx];
+        path.push_back(grid.point(idx));
+    }
+    return path;
+}
+
+/** Follow the parents computed on the fly from the given point, and append them to the path. */
+template<typename Stencil = octo_stencil>
+void path_descend(const costs_t & costs, size_t idx, path_t & path)
+{
+    const grid_t & grid = costs.grid();
+    for( idx = parent_of<Stencil>(costs, idx); idx != no_parent; idx = parent_of<Stencil>(costs, idx) ) {
+        path.push_back(grid.point(idx));
+    }
+}
+
+/** Descend the gradient of the bilinear interpolation of the costs, from the given target, down to a seed.
+
+    At each step, the gradient is computed in the grid cell holding the current point,
+    and the point moves against it, by a fixed fraction of the grid step.
+    In the cells having a corner without cost (e.g. along obstacles), or where the gradient vanishes,
+    the path jumps to the parent of the nearest grid point instead.
+    The path ends on the nearest grid point having no parent (a seed).
+
+  \param step_ratio The length of the steps, as a fraction of the grid step.
+  \param max_steps The number of gradient steps after which the path only follows the parents
+                   (zero for the number of grid points divided by the step ratio).
+  \return The points of the path, or an empty path if the target has no cost.
+ */
+template<typename Stencil = octo_stencil>
+path_t path_gradient(const costs_t & costs, const point_t & target, double step_ratio = 0.5, size_t max_steps = 0)
+{
+    assert(0 < step_ratio and step_ratio <= 1);
+    const grid_t & grid = costs.grid();
+    const double inf = std::numeric_limits<double>::infinity();
+    const double h = step_ratio * grid.step;
+    if( max_steps == 0 ) {
+        max_steps = static_cast<size_t>(grid.size() / step_ratio);
+    }
+
+    path_t path;
+    size_t idx = grid.index(target);
+    if( costs.at(idx) == inf ) {
+        return path;
+    }
+    point_t q = target;
+    path.push_back(q);
+
+    size_t parent = parent_of<Stencil>(costs, idx);
+    for( size_t s = 0; s < max_steps; ++s ) {
+        // Steps are shorter than the grid step, the parent only changes with the nearest grid point.
+        size_t nearest = grid.index(q);
+        if( nearest != idx ) {
+            idx = nearest;
+            parent = parent_of<Stencil>(costs, idx);
+        }
+        if( parent == no_parent ) {
+            // Reached a seed.
+            break;
+        }
+
+        // The cell holding q, clamped to the last ones on the borders.
+        double fx = (x(q) - x(grid.pmin)) / grid.step;
+        double fy = (y(q) - y(grid.pmin)) / grid.step;
+        long i = std::min( std::max(0L, static_cast<long>(std::floor(fx))), static_cast<long>(grid.width) - 2 );
+        long j = std::min( std::max(0L, static_cast<long>(std::floor(fy))), static_cast<long>(grid.height) - 2 );
+        double gx = 0, gy = 0;
+        if( i >= 0 and j >= 0 ) {
+            double c00 = costs.at(grid.index(i  ,j  ));
+            double c10 = costs.at(grid.index(i+1,j  ));
+            double c01 = costs.at(grid.index(i  ,j+1));
+            double c11 = costs.at(grid.index(i+1,j+1));
+            if( c00 < inf and c10 < inf and c01 < inf and c11 < inf ) {
+                double u = std::min(1.0, std::max(0.0, fx - i));
+                double v = std::min(1.0, std::max(0.0, fy - j));
+                gx = ((1-v)*(c10 - c00) + v*(c11 - c01)) / grid.step;
+                gy = ((1-u)*(c01 - c00) + u*(c11 - c10)) / grid.step;
+            }
+        }
+        double norm = std::sqrt(gx*gx + gy*gy);
+        if( norm > 0 ) {
+            x(q) -= h * gx / norm;
+            y(q) -= h * gy / norm;
+            // Stay within the grid.
+            x(q) = std::min( std::max(x(q), x(grid.pmin)), x(grid.pmin) + (grid.width-1) * grid.step );
+            y(q) = std::min( std::max(y(q), y(grid.pmin)), y(grid.pmin) + (grid.height-1) * grid.step );
+            // The interpolation may lead into an obstacle's corner.
+            if( costs.at(q) < inf ) {
+                path.push_back(q);
+                continue;
+            }
+        }
+        q = grid.point(parent);
+        path.push_back(q);
+    }
+    // Snap on the seed, or finish along the parents if the steps ran out.
+    idx = grid.index(q);
+    if( grid.point(idx) != q ) {
+        path.push_back(grid.point(idx));
+    }
+    path_descend<Stencil>(costs, idx, path);
+    return path;
+}
+
+//! The length of the given path.
+inline double path_length(const path_t & path)
+{
+    double length = 0;
+    for( size_t k = 1; k < path.size(); ++k ) {
+        length += distance(path[k-1], path[k]);
+    }
+    return length;
+}
+
+/** Extract the paths from all the given targets, in parallel on the given pool.
+
+    The extract function is called concurrently, and should only read shared data
+    (typically, capture the costs and parents by reference).
+
+  \param chunk The number of targets handled by each task of the pool.
+  \return The paths, in the order of the targets.
+ */
+inline std::vector<path_t> paths_run(
+        const std::vector<point_t> & targets,
+        work_stealing_pool & pool,
+        std::function< path_t(const point_t &) > extract,
+        size_t chunk = 64
+    )
+{
+    std::vector<path_t> paths(targets.size());
+    for( size_t first = 0; first < targets.size(); first += chunk ) {
+        pool.submit( [&,first] (unsigned int) {
+            size_t last = std::min(first + chunk, targets.size());
+            for( size_t t = first; t < last; ++t ) {
+                // Each target has its own slot, no need to lock.
+                paths[t] = extract(targets[t]);
+            }
+        });
+    }
+    pool.wait();
+    return paths;
+}
+
+/** Extract the paths along the parents, for costs computed on edges. */
+template<typename Stencil = octo_stencil>
+std::vector<path_t> paths_on_edge(const costs_t & costs, const std::vector<point_t> & targets, work_stealing_pool & pool)
+{
+    const parents_t parents = paths_parents<Stencil>(costs, pool);
+    return paths_run(targets, pool, [&] (const point_t & target) {return path_parents(parents, costs, target);});
+}
+
+/** Extract the paths along the gradient, for costs computed in simplexes. */
+template<typename Stencil = octo_stencil>
+std::vector<path_t> paths_in_simplex(const costs_t & costs, const std::vector<point_t> & targets, work_stealing_pool & pool, double step_ratio = 0.5)
+{
+    return paths_run(targets, pool, [&] (const point_t & target) {return path_gradient<Stencil>(costs, target, step_ratio);});
+}
+
+/** @} Paths */
@@ -12,38 +12,72 @@
 #include <ratio>
 
 #include "code.h"
+#include "batch.h"
+#include "workspace.h"
+#include "ndim.h"
+#include "simd.h"
 
 namespace neighbors {
 
-    template<int STEP, int PMIN_X, int PMIN_Y, int PMAX_X, int PMAX_Y>
+    template<int STEP, int PMIN_X, int PMIN_Y, int PMAX_X, int PMAX_Y, layout_t LAYOUT = layout_t::row_major>
     class quad_grid
     {
         protected:
-            const double grid_step = STEP;
-            const point_t pmin = {PMIN_X, PMIN_Y};
-            const point_t pmax = {PMAX_X, PMAX_Y};
+            const grid_t grid = grid_t({PMIN_X, PMIN_Y}, {PMAX_X, PMAX_Y}, STEP, LAYOUT);
 
             neighbors_t neighbors(const point_t & p)
             {
-                // neighborhood (list) of relative locations (vector)
-                // Should be given in [clockwise] order.
-                std::vector<point_t> directions{{1,0},{0,-1},{-1,0},{0,1}};
-                return neighbors_grid(p,grid_step,pmin,pmax,directions);
+                // The stencil holds the relative locations, in [clockwise] order.
+                return neighbors_grid<quad_stencil>(p,grid);
             }
     };
 
-    template<int STEP, int PMIN_X, int PMIN_Y, int PMAX_X, int PMAX_Y>
+    template<int STEP, int PMIN_X, int PMIN_Y, int PMAX_X, int PMAX_Y, layout_t LAYOUT = layout_t::row_major>
     class octo_grid
     {
         protected:
-            const double grid_step = STEP;
-            const point_t pmin = {PMIN_X, PMIN_Y};
-            const point_t pmax = {PMAX_X, PMAX_Y};
+            const grid_t grid = grid_t({PMIN_X, PMIN_Y}, {PMAX_X, PMAX_Y}, STEP, LAYOUT);
 
             neighbors_t neighbors(const point_t & p)
             {
-                std::vector<point_t> directions{{1,0},{1,-1},{0,-1},{-1,-1},{-1,0},{-1,1},{0,1},{1,1}};
-                return neighbors_grid(p,grid_step,pmin,pmax,directions);
+                return neighbors_grid<octo_stencil>(p,grid);
+            }
+    };
+
+    //! The point of dimension D having the same coordinate along each axis (a corner of the box).
+    template<size_t D, int PMIN>
+    point_n<D> corner_n()
+    {
+        point_n<D> p;
+        p.fill(PMIN);
+        return p;
+    }
+
+    //! The neighbors along the axes, on a grid of dimension D (see axis_stencil).
+    template<size_t D, int STEP, int PMIN, int PMAX>
+    class axis_grid_n
+    {
+        protected:
+            const grid_n<D> grid = grid_n<D>(corner_n<D,PMIN>(), corner_n<D,PMAX>(), STEP);
+            const stencil_n<D> stencil = axis_stencil<D>();
+
+            neighbors_n<D> neighbors(const point_n<D> & p)
+            {
+                return neighbors_grid_n(p,grid,stencil);
+            }
+    };
+
+    //! The 3^D-1 neighbors of the surrounding cube, on a grid of dimension D (see cube_stencil).
+    template<size_t D, int STEP, int PMIN, int PMAX>
+    class cube_grid_n
+    {
+        protected:
+            const grid_n<D> grid = grid_n<D>(corner_n<D,PMIN>(), corner_n<D,PMAX>(), STEP);
+            const stencil_n<D> stencil = cube_stencil<D>();
+
+            neighbors_n<D> neighbors(const point_n<D> & p)
+            {
+                return neighbors_grid_n(p,grid,stencil);
             }
     };
 }
@@ -53,9 +87,16 @@ namespace transit {
     class on_edge
     {
         protected:
-            double transit(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
+            template<typename Real, template<typename> class Costs>
+            Real transit(const point_t & p, const neighbors_t & neighbors, const Costs<Real> & costs)
             {
-                return transit_on_edge(p,neighbors,costs);
+                return transit_on_edge_of(p,neighbors,costs);
+            }
+
+            template<size_t D>
+            double transit(const point_n<D> & p, const neighbors_n<D> & neighbors, const costs_n<D> & costs)
+            {
+                return transit_on_edge_n(p,neighbors,costs);
             }
     };
 
@@ -66,58 +107,223 @@ namespace transit {
             const double eps;
             in_simplex() : eps(static_cast<double>(EPS::num)/static_cast<double>(EPS::den)) {}
 
+            template<typename Real, template<typename> class Costs>
+            Real transit(const point_t & p, const neighbors_t & neighbors, const Costs<Real> & costs)
+            {
+                return transit_in_simplex_of(p,neighbors,costs, this->eps);
+            }
+    };
+
+    class in_simplex_exact
+    {
+        protected:
+            template<typename Real, template<typename> class Costs>
+            Real transit(const point_t & p, const neighbors_t & neighbors, const Costs<Real> & costs)
+            {
+                return transit_in_simplex_exact_of(p,neighbors,costs);
+            }
+
+            //! The tetrahedral update in 3D (see transit_in_simplex_n).
+            template<size_t D>
+            double transit(const point_n<D> & p, const neighbors_n<D> & neighbors, const costs_n<D> & costs)
+            {
+                return transit_in_simplex_n(p,neighbors,costs);
+            }
+    };
+
+    /** Same as on_edge, vectorized with the best kernels of the CPU (see simd.h).
+
+        Only on double precision costs_t. */
+    class on_edge_simd
+    {
+        protected:
             double transit(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
             {
-                return transit_in_simplex(p,neighbors,costs, this->eps);
+                return transit_on_edge_simd(p,neighbors,costs);
+            }
+    };
+
+    /** Same as in_simplex, vectorized with the best kernels of the CPU (see simd.h).
+
+        Only on double precision costs_t. */
+    template<typename EPS>
+    class in_simplex_simd
+    {
+        protected:
+            const double eps;
+            in_simplex_simd() : eps(static_cast<double>(EPS::num)/static_cast<double>(EPS::den)) {}
+
+            double transit(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
+            {
+                return transit_in_simplex_simd(p,neighbors,costs, this->eps);
             }
     };
 }
 
 
-template<typename NeighborsPolicy, typename TransitPolicy>
+/** \tparam Real The type of the costs computed from a single seed (the other runs are in double precision).
+                 The other compositions, and the vectorized transits, only compute in double precision. */
+template<typename NeighborsPolicy, typename TransitPolicy, typename Front = front_t, typename Real = double>
 class algo : private NeighborsPolicy, private TransitPolicy
 {
 
     public:
         using NeighborsPolicy::neighbors;
+        using NeighborsPolicy::grid;
         using TransitPolicy::transit;
 
-        costs_t operator()(point_t seed, unsigned int iterations)
+        //! If stats is not null, it is filled with the counters and timers of the propagation (see algo_stats_t).
+        costs_of<Real> operator()(point_t seed, unsigned int iterations, algo_stats_t * stats = nullptr, std::ostream * progress = &std::cout)
         {
-            costs_t costs;
+            const grid_t & grid = this->grid;
+            costs_of<Real> costs(grid);
 
             // Make a priority queue of considered nodes.
-            auto compare = [&costs](const point_t& lhs, const point_t& rhs) { return costs[lhs] > costs[rhs]; };
-            front_t front(compare);
+            Front front(grid);
 
             // Start the front from the seed
             costs[seed] = 0;
-            front.push(seed);
+            front.push(grid.index(seed), 0);
+            ALGO_STATS(stats, stats->pushes++; stats->max_front = 1);
+
+            propagate(costs, nullptr, front, iterations, progress, stats);
+            return costs;
+        }
+
+        /** Propagate the front from the seed, on the grid of dimension D of the neighbors policy (e.g. neighbors::cube_grid_n).
+
+            Only on the on_edge and in_simplex_exact transits, in double precision. */
+        template<size_t D>
+        costs_n<D> operator()(const point_n<D> & seed, size_t iterations)
+        {
+            auto around = [this] (const point_n<D> & p) {return this->neighbors(p);};
+            auto hopf_lax = [this] (const point_n<D> & p, const neighbors_n<D> & n, const costs_n<D> & c) {return this->transit(p, n, c);};
+            return algo_run_n<Front>(this->grid, seed, iterations, around, hopf_lax);
+        }
+
+        //! Compare the costs from the seed with the ones of the same algorithm in double precision, without printing progress.
+        deviation_t validate(point_t seed, unsigned int iterations)
+        {
+            algo<NeighborsPolicy, TransitPolicy, Front, double> reference;
+            return costs_deviation((*this)(seed, iterations, nullptr, nullptr), reference(seed, iterations, nullptr, nullptr));
+        }
+
+        labeled_costs_t operator()(const std::vector<seed_t> & seeds, unsigned int iterations)
+        {
+            const grid_t & grid = this->grid;
+            labeled_costs_t result(grid);
+            Front front(grid);
+
+            // Start the front from all the seeds.
+            for( size_t k = 0; k < seeds.size(); ++k ) {
+                size_t idx = grid.index(seeds[k].point);
+                if( seeds[k].cost < result.costs[idx] ) {
+                    result.costs[idx] = seeds[k].cost;
+                    result.labels[idx] = k;
+                    front.update(idx, seeds[k].cost);
+                }
+            }
+
+            propagate(result.costs, &result.labels, front, iterations);
+            return result;
+        }
+
+        //! Propagate the front from the query's seed, in the given (reset) buffers, without printing progress.
+        void operator()(scratch_t<Front> & scratch, const query_t & query)
+        {
+            scratch.costs[query.seed] = 0;
+            scratch.front.push(this->grid.index(query.seed), 0);
+            propagate(scratch.costs, nullptr, scratch.front, query.iterations, nullptr);
+        }
+
+        /** Propagate the front from the seed in the workspace, reusing its buffers, without printing progress.
+
+            \return The costs, valid until the next run in the workspace. */
+        const touched_costs<Real> & operator()(workspace_t<Front,Real> & workspace, point_t seed, unsigned int iterations)
+        {
+            workspace.reset(this->grid);
+            workspace.costs[seed] = 0;
+            workspace.front().push(this->grid.index(seed), 0);
+            propagate(workspace.costs, nullptr, workspace.front(), iterations, nullptr);
+            return workspace.costs;
+        }
+
+        /** Compute the cost from the seed to the target only, with the A* heuristic (see algo_goal_propagate).
+
+            For the transits in simplexes, the heuristic_scale should be the simplex_heuristic_scale of the stencil. */
+        goal_cost_t goal(point_t seed, point_t target, unsigned int iterations, double heuristic_scale = 1)
+        {
+            costs_of<Real> costs(this->grid);
+            Front front(this->grid);
+            return goal_propagate(costs, front, seed, target, iterations, heuristic_scale);
+        }
+
+        //! Same, in the buffers of the workspace, so that the time only grows with the number of points reached.
+        goal_cost_t goal(workspace_t<Front,Real> & workspace, point_t seed, point_t target, unsigned int iterations, double heuristic_scale = 1)
+        {
+            workspace.reset(this->grid);
+            return goal_propagate(workspace.costs, workspace.front(), seed, target, iterations, heuristic_scale);
+        }
+
+    protected:
+        template<typename R, template<typename> class Costs>
+        goal_cost_t goal_propagate(Costs<R> & costs, Front & front, point_t seed, point_t target, unsigned int iterations, double heuristic_scale)
+        {
+            costs[seed] = 0;
+            front.push(this->grid.index(seed), heuristic_scale * distance(seed, target));
+            auto around = [this] (const point_t & p) {return this->neighbors(p);};
+            auto hopf_lax = [this] (const point_t & p, const neighbors_t & n, const Costs<R> & c) {return this->transit(p, n, c);};
+            return algo_goal_propagate(costs, front, target, iterations, around, hopf_lax, heuristic_scale);
+        }
+
+        template<typename R, template<typename> class Costs>
+        void propagate(Costs<R> & costs, labels_t * labels, Front & front, unsigned int iterations, std::ostream * progress = &std::cout, algo_stats_t * stats = nullptr)
+        {
+            const grid_t & grid = this->grid;
 
             unsigned int i=0;
             while(i++ < iterations and not front.empty()) {
-                std::cout << "\r" << i << "/" << iterations;
+                if( progress ) {
+                    *progress << "\r" << i << "/" << iterations;
+                }
 
                 // Accept the node with the min cost and update neighbors.
                 // Accept the considered node with the min cost.
-                point_t accepted = front.top(); front.pop();
+                size_t ia = ALGO_STATS_TIMED(stats, front_time, front.pop());
+                ALGO_STATS(stats, stats->pops++; stats->accepted++);
+                point_t accepted = grid.point(ia);
                 // Consider neighbors of the accepted node.
-                neighbors_t around = neighbors(accepted);
+                neighbors_t around = ALGO_STATS_TIMED(stats, neighbors_time, neighbors(accepted));
+                ALGO_STATS(stats, stats->neighborhoods++);
                 assert(around.size()>0);
-                for( auto n : around ) {
-                    // If no cost has been computed (i.e. the node is "open").
-                    if( not has_cost(n, costs)) {
+                // The indices of the neighbors on the grid, if they are the ones of the costs.
+                const bool indexed = neighbors_indexed(around, costs);
+                for( size_t k = 0; k < around.size(); ++k ) {
+                    const point_t & n = around[k];
+                    size_t in = indexed ? around.index(k) : grid.index(n);
+                    // If the node has not been accepted yet
+                    // (i.e. the node is "open", or is in the front with a tentative cost).
+                    if( not (costs.at(in) < std::numeric_limits<R>::infinity()) or front.contains(in) ) {
                         // Compute costs.
-                        costs[n] = transit(n, neighbors(n), costs);
-                        front.push(n);
+                        neighbors_t simplex = ALGO_STATS_TIMED(stats, neighbors_time, neighbors(n));
+                        R c = ALGO_STATS_TIMED(stats, transit_time, transit(n, simplex, costs));
+                        ALGO_STATS(stats, stats->neighborhoods++; stats->transits++);
+                        if( c < costs[in] ) {
+                            costs[in] = c;
+                            ALGO_STATS_TIMED(stats, front_time, front.update(in, c));
+                            ALGO_STATS(stats, stats->pushes++; stats->max_front = std::max(stats->max_front, front.size()));
+                            if( labels ) {
+                                (*labels)[in] = (*labels)[ia];
+                            }
+                        }
                     }
                 }
             }
-            return costs;
         }
 };
 
 
+#ifndef ALGOPATTERN_NO_MAIN
 int main()
 {
     point_t seed; x(seed)= 0;y(seed)= 0;
@@ -127,7 +333,6 @@ int main()
         assert(x(seed) >= x(pmin));
         assert(y(seed) <= y(pmax));
         assert(y(seed) >= y(pmin));
-    double step = 1;
     unsigned int maxit=300;
 
     using four  = neighbors::quad_grid</*seed*/1, /*x(pmin)*/-5, /*y(pmin)*/-5, /*x(pmax)*/15, /*y(pmax)*/15>;
@@ -135,28 +340,110 @@ int main()
 
     using graph = transit::on_edge;
     using mesh  = transit::in_simplex</*epsilon=*/std::ratio<1,100>>;
+    using exact = transit::in_simplex_exact;
 
     algo<four,graph> dijkstra4;
     std::cout << "Dijkstra, 4 neighbors" << std::endl;
     costs_t cd4 = dijkstra4(seed, maxit);
     std::cout << std::endl;
-    grid_print(cd4, pmin, pmax, step);
+    grid_print(cd4);
 
     algo<four,mesh> fast_marching4;
     std::cout << "Fast marching, 4 neighbors" << std::endl;
     costs_t cfm4 = fast_marching4(seed, maxit);
     std::cout << std::endl;
-    grid_print(cfm4, pmin, pmax, step);
+    grid_print(cfm4);
+
+    algo<four,exact> exact_fast_marching4;
+    std::cout << "Exact fast marching, 4 neighbors" << std::endl;
+    costs_t cxfm4 = exact_fast_marching4(seed, maxit);
+    std::cout << std::endl;
+    grid_print(cxfm4);
 
     algo<eight,graph> dijkstra8;
     std::cout << "Dijkstra, 8 neighbors" << std::endl;
     costs_t cd8 = dijkstra8(seed, maxit);
     std::cout << std::endl;
-    grid_print(cd8, pmin, pmax, step);
+    grid_print(cd8);
 
     algo<eight,mesh> fast_marching8;
     std::cout << "Fast marching, 8 neighbors" << std::endl;
     costs_t cfm8 = fast_marching8(seed, maxit);
     std::cout << std::endl;
-    grid_print(cfm8, pmin, pmax, step);
+    grid_print(cfm8);
+
+    algo<eight,exact> exact_fast_marching8;
+    std::cout << "Exact fast marching, 8 neighbors" << std::endl;
+    costs_t cxfm8 = exact_fast_marching8(seed, maxit);
+    std::cout << std::endl;
+    grid_print(cxfm8);
+
+    point_t target = make_point(10,10);
+    goal_cost_t gxfm8 = exact_fast_marching8.goal(seed, target, maxit, simplex_heuristic_scale<octo_stencil>());
+    std::cout << "A* exact fast marching, 8 neighbors, to (10,10): " << gxfm8.cost << " (" << gxfm8.expanded << " accepted, vs. " << cxfm8.at(target) << ")" << std::endl;
+    std::cout << std::endl;
+
+    algo<eight,transit::in_simplex_simd<std::ratio<1,100>>> vectorized_fast_marching8;
+    std::cout << "Fast marching, 8 neighbors, vectorized (" << simd_kernels().name << ")" << std::endl;
+    costs_t cvfm8 = vectorized_fast_marching8(seed, maxit);
+    std::cout << std::endl;
+    grid_print(cvfm8);
+
+    // Store the costs and the front's positions in Z-order.
+    algo<neighbors::octo_grid<1, -5, -5, 15, 15, layout_t::morton>,exact> morton_fast_marching8;
+    std::cout << "Exact fast marching, 8 neighbors, Morton layout" << std::endl;
+    costs_t cmxfm8 = morton_fast_marching8(seed, maxit);
+    std::cout << std::endl;
+    grid_print(cmxfm8);
+
+    // Halve the memory taken by the costs.
+    algo<eight,exact,front_t,float> single_fast_marching8;
+    std::cout << "Exact fast marching, 8 neighbors, single precision" << std::endl;
+    costs_of<float> csxfm8 = single_fast_marching8(seed, maxit);
+    std::cout << std::endl;
+    grid_print(csxfm8);
+    deviation_t deviation = single_fast_marching8.validate(seed, maxit);
+    std::cout << "Max deviation from double precision: " << deviation.max_abs
+              << " (relative: " << deviation.max_rel << ")" << std::endl << std::endl;
+
+    // Accept nodes by buckets of costs as wide as the grid step.
+    algo<eight,exact,bucket_front<std::ratio<1>>> untidy_fast_marching8;
+    std::cout << "Untidy fast marching, 8 neighbors" << std::endl;
+    costs_t cufm8 = untidy_fast_marching8(seed, maxit);
+    std::cout << std::endl;
+    grid_print(cufm8);
+
+    std::vector<seed_t> seeds{ {{0,0},0}, {{10,10},0}, {{12,-3},2} };
+    std::cout << "Dijkstra, 8 neighbors, 3 seeds" << std::endl;
+    labeled_costs_t lcd8 = dijkstra8(seeds, maxit);
+    std::cout << std::endl;
+    grid_print(lcd8.costs);
+    labels_print(lcd8.labels, lcd8.costs.grid());
+
+    std::vector<query_t> queries{ {{0,0},maxit}, {{10,10},maxit}, {{12,-3},maxit}, {{-5,15},maxit} };
+    work_stealing_pool pool(2);
+    std::cout << "Batch of Dijkstra, 8 neighbors" << std::endl;
+    std::vector<costs_t> batch = batch_run<front_t>(dijkstra8.grid, queries, pool,
+            [&dijkstra8](scratch_t<> & scratch, const query_t & query) {dijkstra8(scratch, query);});
+    for( size_t q = 0; q < queries.size(); ++q ) {
+        std::cout << "from (" << x(queries[q].seed) << "," << y(queries[q].seed) << ") to (5,5): " << batch[q].at(make_point(5,5)) << std::endl;
+    }
+    std::cout << std::endl;
+
+    // The same queries, one after the other, reusing the same buffers.
+    workspace_t<> workspace;
+    std::cout << "Successive Dijkstra, 8 neighbors, in a workspace" << std::endl;
+    for( const query_t & query : queries ) {
+        const touched_costs<> & costs = dijkstra8(workspace, query.seed, query.iterations);
+        std::cout << "from (" << x(query.seed) << "," << y(query.seed) << ") to (5,5): " << costs.at(make_point(5,5)) << std::endl;
+    }
+    std::cout << std::endl;
+
+    // The same operators, on a 21x21x21 volume.
+    algo<neighbors::cube_grid_n<3, 1, -5, 15>, exact> exact_fast_marching26;
+    std::cout << "Exact fast marching, 26 neighbors, in 3D" << std::endl;
+    costs_n<3> cxfm26 = exact_fast_marching26(point_n<3>{{0,0,0}}, exact_fast_marching26.grid.size());
+    std::cout << "from (0,0,0) to (5,5,5): " << cxfm26.at(point_n<3>{{5,5,5}}) << " (vs. " << std::sqrt(75.0) << ")" << std::endl;
+    std::cout << std::endl;
 }
+#endif // ALGOPATTERN_NO_MAIN
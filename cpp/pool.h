@@ -0,0 +1,157 @@
+#pragma once
+
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <cassert>
+
+/** A pool of threads, each one having its own queue of tasks and stealing from the others when it is empty.
+
+    Tasks are distributed across the queues in a round robin fashion.
+    A worker takes its tasks at the back of its own queue,
+    and steals tasks at the front of the other queues.
+    Tasks are given the index of the worker running them,
+    which allows them to use per-worker data without locking.
+    Tasks may be submitted from several threads.
+    If a task throws, the exception is rethrown by wait() (the first one only, if several do).
+  */
+class work_stealing_pool
+{
+    public:
+        using task_t = std::function< void(unsigned int worker) >;
+
+        work_stealing_pool(unsigned int workers = std::max(1U, std::thread::hardware_concurrency()))
+            : _next(0), _queued(0), _pending(0), _stop(false)
+        {
+            assert(workers > 0);
+            for( unsigned int w = 0; w < workers; ++w ) {
+                _queues.push_back( std::unique_ptr<queue_t>(new queue_t) );
+            }
+            for( unsigned int w = 0; w < workers; ++w ) {
+                _threads.push_back( std::thread(&work_stealing_pool::loop, this, w) );
+            }
+        }
+
+        ~work_stealing_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _work.notify_all();
+            for( std::thread & t : _threads ) {
+                t.join();
+            }
+        }
+
+        //! Number of workers.
+        unsigned int size() const {return static_cast<unsigned int>(_queues.size());}
+
+        void submit(task_t task)
+        {
+            queue_t & q = *_queues[_next++ % _queues.size()];
+            {
+                std::lock_guard<std::mutex> lock(q.mutex);
+                q.tasks.push_back(std::move(task));
+            }
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _queued++;
+                _pending++;
+            }
+            _work.notify_one();
+        }
+
+        //! Block until all the submitted tasks are done.
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _done.wait(lock, [this](){return _pending == 0;});
+            if( _error ) {
+                std::exception_ptr error = _error;
+                _error = nullptr;
+                std::rethrow_exception(error);
+            }
+        }
+
+    protected:
+        struct queue_t
+        {
+            std::mutex mutex;
+            std::deque<task_t> tasks;
+        };
+        std::vector< std::unique_ptr<queue_t> > _queues;
+        std::vector<std::thread> _threads;
+        std::atomic<size_t> _next;
+
+        //! Protects the counters and the stop flag.
+        std::mutex _mutex;
+        std::condition_variable _work;
+        std::condition_variable _done;
+        //! Tasks waiting in a queue.
+        size_t _queued;
+        //! Tasks submitted and not yet done.
+        size_t _pending;
+        bool _stop;
+        //! The first exception thrown by a task since the last wait.
+        std::exception_ptr _error;
+
+        //! Take a task from the given worker's own queue, or else steal one.
+        bool take(unsigned int worker, task_t & task)
+        {
+            for( size_t k = 0; k < _queues.size(); ++k ) {
+                queue_t & q = *_queues[(worker + k) % _queues.size()];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                if( not q.tasks.empty() ) {
+                    if( k == 0 ) {
+                        task = std::move(q.tasks.back());
+                        q.tasks.pop_back();
+                    } else {
+                        task = std::move(q.tasks.front());
+                        q.tasks.pop_front();
+                    }
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void loop(unsigned int worker)
+        {
+            while( true ) {
+                task_t task;
+                if( take(worker, task) ) {
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _queued--;
+                    }
+                    std::exception_ptr error;
+                    try {
+                        task(worker);
+                    } catch(...) {
+                        error = std::current_exception();
+                    }
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if( error and not _error ) {
+                        _error = error;
+                    }
+                    if( --_pending == 0 ) {
+                        _done.notify_all();
+                    }
+                } else {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    if( _stop ) {
+                        return;
+                    }
+                    _work.wait(lock, [this](){return _stop or _queued > 0;});
+                }
+            }
+        }
+};
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include "code.h"
+
+/** \defgroup Replan Incremental replanning, when the domain changes.
+
+    Instead of propagating again from scratch when some points of the domain change
+    (e.g. a speed field gets an obstacle, or a faster region),
+    the previous costs are repaired around the changed points only,
+    in the spirit of D* Lite and of the dynamic fast marching methods:
+
+    1. Raise: the points whose cost cannot be recomputed anymore from their neighbors
+       (because they, or the points supporting them, got more expensive) are invalidated,
+       in increasing order of their previous costs.
+       The invalidation spreads to the neighbors of the invalidated points, and stops
+       as soon as a point's transit still gives its previous cost.
+    2. Lower: a front is started from the valid points bordering the invalidated region,
+       and from the points which got cheaper, and propagated as long as costs decrease.
+
+    The neighborhood and transit functions are the same as the ones of algo_run,
+    and should reflect the changes (e.g. by sharing a speed field, see speed_field_t::set_speed).
+    The invalidation spreads across the whole stencil, obstacles included: if the neighborhood
+    has none for the obstacles (see neighbors_grid_if), the full stencil should be given apart.
+
+  @{
+*/
+
+/** Keep the costs of a propagation, and repair them when some points change.
+
+    \tparam Front The front used for the repair (the invalidation needs keys in any order, and uses a heap_front).
+*/
+template<typename Front = front_t>
+class replanner_t
+{
+    public:
+        using neighbors_f = std::function< neighbors_t(const point_t&) >;
+        using transit_f = std::function< double(const point_t &, const neighbors_t &, const costs_t &) >;
+
+        /** Propagate the whole grid from the given seeds.
+
+            \param tolerance Relative difference under which two costs are considered equal.
+            \param around The points whose transit may use a given one, even an obstacle
+                          (e.g. neighbors_grid<Stencil>(p,grid)); the neighbors if empty. */
+        replanner_t(const grid_t & grid, const std::vector<seed_t> & seeds, neighbors_f neighbors, transit_f transit, double tolerance = 1e-9, neighbors_f around = nullptr) :
+            _costs(grid),
+            _seeds(seeds),
+            _is_seed(grid.size(), false),
+            _neighbors(neighbors),
+            _around(around ? around : neighbors),
+            _transit(transit),
+            _tolerance(tolerance),
+            _check(grid),
+            _front(grid),
+            _accepted(grid.size(), 0),
+            _generation(0)
+        {
+            for( const seed_t & seed : _seeds ) {
+                size_t idx = grid.index(seed.point);
+                _is_seed[idx] = true;
+                if( seed.cost < _costs[idx] ) {
+                    _costs[idx] = seed.cost;
+                    _front.update(idx, seed.cost);
+                }
+            }
+            algo_propagate(_costs, nullptr, _front, grid.size(), _neighbors, _transit, nullptr);
+        }
+
+        replanner_t(const grid_t & grid, point_t seed, neighbors_f neighbors, transit_f transit, double tolerance = 1e-9, neighbors_f around = nullptr) :
+            replanner_t(grid, std::vector<seed_t>{ {seed, 0} }, neighbors, transit, tolerance, around)
+        {}
+
+        const costs_t & costs() const {return _costs;}
+
+        /** Repair the costs after the given points have changed.
+
+            \return The number of transits computed during the repair. */
+        size_t update(const std::vector<point_t> & changed)
+        {
+            const grid_t & grid = _costs.grid();
+            const double inf = std::numeric_limits<double>::infinity();
+            size_t transits = 0;
+            _check.clear();
+            _front.clear();
+
+            // The valid points around the given one will start the lower front.
+            auto border = [&] (const point_t & p) {
+                for( auto n : _around(p) ) {
+                    size_t in = grid.index(n);
+                    if( _costs[in] < inf ) {
+                        _front.update(in, _costs[in]);
+                    }
+                }
+            };
+
+            // Raise.
+            for( const point_t & p : changed ) {
+                size_t idx = grid.index(p);
+                if( _is_seed[idx] ) {
+                    continue;
+                }
+                if( _costs[idx] < inf ) {
+                    _check.update(idx, _costs[idx]);
+                } else {
+                    // Was not reached (e.g. a removed obstacle), but may be now.
+                    border(p);
+                }
+            }
+            std::vector<size_t> invalidated;
+            while( not _check.empty() ) {
+                size_t idx = _check.pop();
+                point_t p = grid.point(idx);
+                double previous = _costs[idx];
+                neighbors_t neighbors = _neighbors(p);
+                double c = inf;
+                // All the neighbors may have been invalidated.
+                if( std::any_of(begin(neighbors), end(neighbors), [&](const point_t & n) {return _costs.at(n) < inf;}) ) {
+                    c = _transit(p, neighbors, _costs);
+                    transits++;
+                }
+                if( c > previous + tol(previous) ) {
+                    _costs[idx] = inf;
+                    invalidated.push_back(idx);
+                    // The points which may have been supported by this one.
+                    for( auto n : _around(p) ) {
+                        size_t in = grid.index(n);
+                        if( not _is_seed[in] and not _check.contains(in) and _costs[in] < inf ) {
+                            _check.update(in, _costs[in]);
+                        }
+                    }
+                } else if( c < previous - tol(previous) ) {
+                    _costs[idx] = c;
+                    _front.update(idx, c);
+                }
+            }
+
+            // Lower, starting from the valid borders of the invalidated region.
+            for( size_t idx : invalidated ) {
+                border(grid.point(idx));
+            }
+            // As in the fast marching, a point is not updated anymore once accepted,
+            // which bounds the repair even if the transit is not exactly causal.
+            _generation++;
+            while( not _front.empty() ) {
+                size_t ia = _front.pop();
+                _accepted[ia] = _generation;
+                for( auto n : _neighbors(grid.point(ia)) ) {
+                    size_t in = grid.index(n);
+                    if( _is_seed[in] or _accepted[in] == _generation ) {
+                        continue;
+                    }
+                    double c = _transit(n, _neighbors(n), _costs);
+                    transits++;
+                    if( c < _costs[in] - tol(_costs[in]) ) {
+                        _costs[in] = c;
+                        _front.update(in, c);
+                    }
+                }
+            }
+            return transits;
+        }
+
+    protected:
+        double tol(double cost) const
+        {
+            return cost < std::numeric_limits<double>::infinity() ? _tolerance * std::max(1.0, cost) : 0;
+        }
+
+        costs_t _costs;
+        std::vector<seed_t> _seeds;
+        std::vector<bool> _is_seed;
+        neighbors_f _neighbors;
+        //! The points whose transit may use a given one.
+        neighbors_f _around;
+        transit_f _transit;
+        double _tolerance;
+        //! Points to check during the raise, by increasing previous costs.
+        heap_front<4> _check;
+        Front _front;
+        //! The points accepted during the current repair are stamped with its generation.
+        std::vector<unsigned int> _accepted;
+        unsigned int _generation;
+};
+
+/** @} Replan */
@@ -0,0 +1,262 @@
+#pragma once
+
+#include "code.h"
+
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+#define ALGOPATTERN_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/** \defgroup SIMD Vectorized transit operators.
+
+    Neighbors are first gathered in a structure of arrays (coordinates and costs),
+    in which a point without cost (yet) holds an infinite cost,
+    so that it is naturally masked out when taking the minimum transit.
+    The kernels then evaluate all the neighbors (for transit_on_edge),
+    or all the samples along an edge (for transit_in_simplex), several at once.
+
+    The kernels are chosen at runtime, according to the instruction sets supported by the CPU:
+    AVX2 (4 doubles at once), SSE2 (2 doubles at once), or a portable scalar fallback.
+    The transit functions have the same signatures as the scalar ones,
+    and can thus be used in the same slots.
+
+  @{
+*/
+
+/** Neighbors coordinates and costs, as a structure of arrays.
+
+    Padded up to the capacity of neighbors_t, with infinite costs. */
+struct soa_neighbors_t
+{
+    static constexpr size_t capacity = neighbors_t::capacity();
+
+    soa_neighbors_t(const neighbors_t & neighbors, const costs_t & costs) : size(neighbors.size())
+    {
+        neighbors_costs(neighbors, costs, cs);
+        for( size_t i = 0; i < capacity; ++i ) {
+            if( i < size ) {
+                xs[i] = x(neighbors[i]);
+                ys[i] = y(neighbors[i]);
+            } else {
+                xs[i] = 0;
+                ys[i] = 0;
+                cs[i] = std::numeric_limits<double>::infinity();
+            }
+        }
+    }
+
+    alignas(32) double xs[capacity];
+    alignas(32) double ys[capacity];
+    alignas(32) double cs[capacity];
+    size_t size;
+};
+
+/** A set of kernels for a given instruction set. */
+struct simd_kernels_t
+{
+    const char* name;
+    //! Minimal transit from p toward all the neighbors.
+    double (*on_edge)(const soa_neighbors_t & n, double px, double py);
+    //! Minimal transit from p across the n regularly spaced samples z=k*eps on the edge [pj,pk].
+    double (*edge_samples)(double px, double py, double xj, double yj, double cj, double xk, double yk, double ck, double eps, size_t n);
+};
+
+/** \defgroup Scalar Portable kernels.
+  @{ */
+inline double scalar_on_edge(const soa_neighbors_t & n, double px, double py)
+{
+    double mincost = std::numeric_limits<double>::infinity();
+    for( size_t i = 0; i < soa_neighbors_t::capacity; ++i ) {
+        double dx = px - n.xs[i];
+        double dy = py - n.ys[i];
+        mincost = std::min(mincost, n.cs[i] + std::sqrt(dx*dx + dy*dy));
+    }
+    return mincost;
+}
+
+inline double scalar_edge_samples(double px, double py, double xj, double yj, double cj, double xk, double yk, double ck, double eps, size_t n)
+{
+    double mincost = std::numeric_limits<double>::infinity();
+    for( size_t k = 0; k < n; ++k ) {
+        double z = k * eps;
+        double dx = px - (z*xj + (1-z)*xk);
+        double dy = py - (z*yj + (1-z)*yk);
+        mincost = std::min(mincost, z*cj + (1-z)*ck + std::sqrt(dx*dx + dy*dy));
+    }
+    return mincost;
+}
+/** @} Scalar */
+
+#ifdef ALGOPATTERN_X86_SIMD
+/** \defgroup SSE2 Kernels processing 2 doubles at once (always available on x86-64).
+  @{ */
+inline double sse2_hmin(__m128d v)
+{
+    return _mm_cvtsd_f64( _mm_min_pd(v, _mm_unpackhi_pd(v, v)) );
+}
+
+inline double sse2_on_edge(const soa_neighbors_t & n, double px, double py)
+{
+    const __m128d vx = _mm_set1_pd(px);
+    const __m128d vy = _mm_set1_pd(py);
+    __m128d vmin = _mm_set1_pd(std::numeric_limits<double>::infinity());
+    for( size_t i = 0; i < soa_neighbors_t::capacity; i += 2 ) {
+        __m128d dx = _mm_sub_pd(vx, _mm_load_pd(n.xs + i));
+        __m128d dy = _mm_sub_pd(vy, _mm_load_pd(n.ys + i));
+        __m128d d  = _mm_sqrt_pd( _mm_add_pd(_mm_mul_pd(dx,dx), _mm_mul_pd(dy,dy)) );
+        vmin = _mm_min_pd(vmin, _mm_add_pd(_mm_load_pd(n.cs + i), d));
+    }
+    return sse2_hmin(vmin);
+}
+
+inline double sse2_edge_samples(double px, double py, double xj, double yj, double cj, double xk, double yk, double ck, double eps, size_t n)
+{
+    const __m128d one = _mm_set1_pd(1);
+    const __m128d inf = _mm_set1_pd(std::numeric_limits<double>::infinity());
+    const __m128d last = _mm_set1_pd(static_cast<double>(n) - 0.5);
+    __m128d vmin = inf;
+    __m128d k = _mm_set_pd(1, 0);
+    const __m128d step = _mm_set1_pd(2);
+    for( size_t s = 0; s < n; s += 2 ) {
+        __m128d z  = _mm_mul_pd(k, _mm_set1_pd(eps));
+        __m128d iz = _mm_sub_pd(one, z);
+        __m128d dx = _mm_sub_pd(_mm_set1_pd(px), _mm_add_pd(_mm_mul_pd(z, _mm_set1_pd(xj)), _mm_mul_pd(iz, _mm_set1_pd(xk))));
+        __m128d dy = _mm_sub_pd(_mm_set1_pd(py), _mm_add_pd(_mm_mul_pd(z, _mm_set1_pd(yj)), _mm_mul_pd(iz, _mm_set1_pd(yk))));
+        __m128d c  = _mm_add_pd( _mm_add_pd(_mm_mul_pd(z, _mm_set1_pd(cj)), _mm_mul_pd(iz, _mm_set1_pd(ck))),
+                                 _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx,dx), _mm_mul_pd(dy,dy))) );
+        // Mask out the samples beyond the end of the edge.
+        __m128d beyond = _mm_cmpgt_pd(k, last);
+        c = _mm_or_pd(_mm_and_pd(beyond, inf), _mm_andnot_pd(beyond, c));
+        vmin = _mm_min_pd(vmin, c);
+        k = _mm_add_pd(k, step);
+    }
+    return sse2_hmin(vmin);
+}
+/** @} SSE2 */
+
+/** \defgroup AVX2 Kernels processing 4 doubles at once.
+  @{ */
+__attribute__((target("avx2,fma")))
+inline double avx2_hmin(__m256d v)
+{
+    __m128d m = _mm_min_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64( _mm_min_pd(m, _mm_unpackhi_pd(m, m)) );
+}
+
+__attribute__((target("avx2,fma")))
+inline double avx2_on_edge(const soa_neighbors_t & n, double px, double py)
+{
+    const __m256d vx = _mm256_set1_pd(px);
+    const __m256d vy = _mm256_set1_pd(py);
+    __m256d vmin = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    for( size_t i = 0; i < soa_neighbors_t::capacity; i += 4 ) {
+        __m256d dx = _mm256_sub_pd(vx, _mm256_load_pd(n.xs + i));
+        __m256d dy = _mm256_sub_pd(vy, _mm256_load_pd(n.ys + i));
+        __m256d d  = _mm256_sqrt_pd( _mm256_fmadd_pd(dx, dx, _mm256_mul_pd(dy,dy)) );
+        vmin = _mm256_min_pd(vmin, _mm256_add_pd(_mm256_load_pd(n.cs + i), d));
+    }
+    return avx2_hmin(vmin);
+}
+
+__attribute__((target("avx2,fma")))
+inline double avx2_edge_samples(double px, double py, double xj, double yj, double cj, double xk, double yk, double ck, double eps, size_t n)
+{
+    const __m256d one = _mm256_set1_pd(1);
+    const __m256d inf = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    const __m256d last = _mm256_set1_pd(static_cast<double>(n) - 0.5);
+    const __m256d veps = _mm256_set1_pd(eps);
+    __m256d vmin = inf;
+    __m256d k = _mm256_set_pd(3, 2, 1, 0);
+    const __m256d step = _mm256_set1_pd(4);
+    for( size_t s = 0; s < n; s += 4 ) {
+        __m256d z  = _mm256_mul_pd(k, veps);
+        __m256d iz = _mm256_sub_pd(one, z);
+        __m256d dx = _mm256_sub_pd(_mm256_set1_pd(px), _mm256_fmadd_pd(z, _mm256_set1_pd(xj), _mm256_mul_pd(iz, _mm256_set1_pd(xk))));
+        __m256d dy = _mm256_sub_pd(_mm256_set1_pd(py), _mm256_fmadd_pd(z, _mm256_set1_pd(yj), _mm256_mul_pd(iz, _mm256_set1_pd(yk))));
+        __m256d c  = _mm256_add_pd( _mm256_fmadd_pd(z, _mm256_set1_pd(cj), _mm256_mul_pd(iz, _mm256_set1_pd(ck))),
+                                    _mm256_sqrt_pd(_mm256_fmadd_pd(dx, dx, _mm256_mul_pd(dy,dy))) );
+        // Mask out the samples beyond the end of the edge.
+        c = _mm256_blendv_pd(c, inf, _mm256_cmp_pd(k, last, _CMP_GT_OQ));
+        vmin = _mm256_min_pd(vmin, c);
+        k = _mm256_add_pd(k, step);
+    }
+    return avx2_hmin(vmin);
+}
+/** @} AVX2 */
+#endif // ALGOPATTERN_X86_SIMD
+
+//! All the kernels available on this CPU, the best one first.
+inline std::vector<simd_kernels_t> simd_available()
+{
+    std::vector<simd_kernels_t> kernels;
+#ifdef ALGOPATTERN_X86_SIMD
+    if( __builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma") ) {
+        kernels.push_back( {"avx2", avx2_on_edge, avx2_edge_samples} );
+    }
+    kernels.push_back( {"sse2", sse2_on_edge, sse2_edge_samples} );
+#endif
+    kernels.push_back( {"scalar", scalar_on_edge, scalar_edge_samples} );
+    return kernels;
+}
+
+//! The best kernels available on this CPU, chosen at the first call.
+inline const simd_kernels_t & simd_kernels()
+{
+    static const simd_kernels_t best = simd_available().front();
+    return best;
+}
+
+/** Find the transit of minimal cost among the given edges, with the given kernels.
+
+    Same as transit_on_edge. */
+inline double transit_on_edge_simd(const point_t & p, const neighbors_t & neighbors, const costs_t & costs, const simd_kernels_t & kernels)
+{
+    soa_neighbors_t soa(neighbors, costs);
+    double mincost = kernels.on_edge(soa, x(p), y(p));
+    // Should be near the front (and thus have found a transit), unless p is impassable (see neighbors_grid_if).
+    assert(neighbors.empty() or mincost != std::numeric_limits<double>::infinity());
+    return mincost;
+}
+
+inline double transit_on_edge_simd(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
+{
+    return transit_on_edge_simd(p, neighbors, costs, simd_kernels());
+}
+
+/** Find the transit in minimal cost within the given simplexes, with the given kernels.
+
+    Same as transit_in_simplex, the samples being z=k*eps for all k such that z<=1. */
+inline double transit_in_simplex_simd(const point_t & p, const neighbors_t & neighbors, const costs_t & costs, double eps, const simd_kernels_t & kernels)
+{
+    soa_neighbors_t soa(neighbors, costs);
+    const size_t samples = static_cast<size_t>(std::floor(1/eps + 1e-9)) + 1;
+    const double inf = std::numeric_limits<double>::infinity();
+
+    double mincost = inf;
+    for( size_t j = 0; j < soa.size; ++j ) {
+        size_t k = (j+1) % soa.size;
+        bool hj = soa.cs[j] < inf;
+        bool hk = soa.cs[k] < inf;
+        double c = inf;
+        if( hj and hk ) {
+            c = kernels.edge_samples(x(p), y(p), soa.xs[j], soa.ys[j], soa.cs[j], soa.xs[k], soa.ys[k], soa.cs[k], eps, samples);
+            // If the front is reached on a single point.
+        } else if( hj ) {
+            c = soa.cs[j] + distance(p, make_point(soa.xs[j], soa.ys[j]));
+        } else if( hk ) {
+            c = soa.cs[k] + distance(p, make_point(soa.xs[k], soa.ys[k]));
+        }
+        mincost = std::min(mincost, c);
+    }
+
+    // Should be near the front (and thus have found a transit), unless p is impassable (see neighbors_grid_if).
+    assert(neighbors.empty() or mincost < inf);
+    return mincost;
+}
+
+inline double transit_in_simplex_simd(const point_t & p, const neighbors_t & neighbors, const costs_t & costs, double eps)
+{
+    return transit_in_simplex_simd(p, neighbors, costs, eps, simd_kernels());
+}
+
+/** @} SIMD */
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "code.h"
+
+/** \defgroup Speed Heterogeneous speed fields.
+
+    A speed field gives, for each point of a grid, the speed at which it can be traversed.
+    A null (or negative, or NaN) speed marks an impassable point (an obstacle).
+
+    Fields are stored as binary rasters: a header (see raster_header_t),
+    followed by the speeds as raw float32, in row-major order (x first, whatever the layout of the grid, see grid_t::row_major),
+    in the native byte order.
+    Such a raster is memory-mapped rather than read:
+    nothing is copied or parsed at startup, and pages are loaded on demand by the system.
+
+  @{
+*/
+
+//! Header of a speed raster file.
+struct raster_header_t
+{
+    char magic[8];
+    uint32_t width;
+    uint32_t height;
+};
+
+//! Magic bytes at the start of a speed raster file.
+const char raster_magic[8] = {'A','L','G','O','S','P','D','1'};
+
+/** A speed field, either memory-mapped (read-only) from a raster file, or held in memory.
+
+    Copies are cheap: they share the same mapping (or buffer). */
+class speed_field_t
+{
+    public:
+        //! Memory-map the raster file at the given path.
+        explicit speed_field_t(const std::string & path)
+        {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if( fd < 0 ) {
+                throw std::runtime_error("cannot open speed raster: " + path);
+            }
+            struct stat st;
+            if( ::fstat(fd, &st) != 0 or static_cast<size_t>(st.st_size) < sizeof(raster_header_t) ) {
+                ::close(fd);
+                throw std::runtime_error("cannot read the header of speed raster: " + path);
+            }
+            size_t bytes = static_cast<size_t>(st.st_size);
+            void* addr = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+            // The mapping holds its own reference to the file.
+            ::close(fd);
+            if( addr == MAP_FAILED ) {
+                throw std::runtime_error("cannot map speed raster: " + path);
+            }
+            _storage = std::shared_ptr<const void>(addr, [bytes](const void* a){ ::munmap(const_cast<void*>(a), bytes); });
+
+            const raster_header_t* header = static_cast<const raster_header_t*>(addr);
+            if( std::memcmp(header->magic, raster_magic, sizeof(raster_magic)) != 0 ) {
+                throw std::runtime_error("not a speed raster: " + path);
+            }
+            _width = header->width;
+            _height = header->height;
+            if( bytes != sizeof(raster_header_t) + _width * _height * sizeof(float) ) {
+                throw std::runtime_error("truncated speed raster: " + path);
+            }
+            _speeds = reinterpret_cast<const float*>(static_cast<const char*>(addr) + sizeof(raster_header_t));
+        }
+
+        //! Hold the given speeds, in row-major order.
+        speed_field_t(const grid_t & grid, std::vector<float> speeds) :
+            _width(grid.width), _height(grid.height)
+        {
+            assert(speeds.size() == grid.width * grid.height);
+            _buffer = std::make_shared< std::vector<float> >(std::move(speeds));
+            _speeds = _buffer->data();
+            _storage = _buffer;
+        }
+
+        size_t width() const {return _width;}
+        size_t height() const {return _height;}
+        size_t size() const {return _width * _height;}
+
+        //! True if the field has the same dimensions than the grid.
+        bool fits(const grid_t & grid) const {return _width == grid.width and _height == grid.height;}
+
+        //! Points are given by their index in row-major order (see grid_t::row_major).
+        float speed(size_t idx) const {assert(idx < size()); return _speeds[idx];}
+        //! False for obstacles (including NaN speeds).
+        bool passable(size_t idx) const {return speed(idx) > 0;}
+        //! The time needed to travel a unit distance at the given point.
+        double slowness(size_t idx) const {return 1.0 / speed(idx);}
+
+        /** Change the speed at the given point, for fields held in memory.
+
+            The change is seen by all the copies of the field (see replanner_t). */
+        void set_speed(size_t idx, float speed) {assert(_buffer and idx < size()); (*_buffer)[idx] = speed;}
+
+    protected:
+        std::shared_ptr<const void> _storage;
+        //! Only for fields held in memory.
+        std::shared_ptr< std::vector<float> > _buffer;
+        const float* _speeds;
+        size_t _width;
+        size_t _height;
+};
+
+//! Write the given speeds (in row-major order) as a raster file.
+inline void speed_raster_write(const std::string & path, const grid_t & grid, const std::vector<float> & speeds)
+{
+    assert(speeds.size() == grid.width * grid.height);
+    raster_header_t header;
+    std::memcpy(header.magic, raster_magic, sizeof(raster_magic));
+    header.width = static_cast<uint32_t>(grid.width);
+    header.height = static_cast<uint32_t>(grid.height);
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(speeds.data()), speeds.size() * sizeof(float));
+    if( not out ) {
+        throw std::runtime_error("cannot write speed raster: " + path);
+    }
+}
+
+/** Neighbors of the given point on the grid, none for the obstacles of the field (see neighbors_grid_if).
+
+    The obstacles are thus never reached. They are kept in the neighborhoods of the other points,
+    in the stencil's order, so that the transits in simplexes only join adjacent neighbors.
+    As the obstacles have no neighbors, the points around a new obstacle should be given apart
+    when repairing the costs (see replanner_t). */
+template<typename Stencil>
+inline neighbors_t neighbors_grid(const point_t & p, const grid_t & grid, const speed_field_t & field)
+{
+    assert(field.fits(grid));
+    return neighbors_grid_if<Stencil>(p, grid, [&grid,&field](size_t idx) {return field.passable(grid.row_major(idx));});
+}
+
+/** Transit on edges, at the speed of the field at the considered point.
+
+    The transit toward an obstacle is infinite (the obstacle may have changed since it was reached, see replanner_t). */
+inline double transit_on_edge_speed(const point_t & p, const neighbors_t & neighbors, const costs_t & costs, const speed_field_t & field)
+{
+    size_t idx = costs.grid().row_major(costs.grid().index(p));
+    if( not field.passable(idx) ) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return transit_on_edge_weighted(p, neighbors, costs, field.slowness(idx));
+}
+
+/** Transit in simplexes, at the speed of the field at the considered point. */
+inline double transit_in_simplex_speed(const point_t & p, const neighbors_t & neighbors, const costs_t & costs, double eps, const speed_field_t & field)
+{
+    size_t idx = costs.grid().row_major(costs.grid().index(p));
+    if( not field.passable(idx) ) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return transit_in_simplex_weighted(p, neighbors, costs, eps, field.slowness(idx));
+}
+
+/** Exact transit in simplexes, at the speed of the field at the considered point. */
+inline double transit_in_simplex_exact_speed(const point_t & p, const neighbors_t & neighbors, const costs_t & costs, const speed_field_t & field)
+{
+    size_t idx = costs.grid().row_major(costs.grid().index(p));
+    if( not field.passable(idx) ) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return transit_in_simplex_exact_weighted(p, neighbors, costs, field.slowness(idx));
+}
+
+/** @} Speed */
@@ -11,16 +11,19 @@
 #include <functional>
 
 #include "code.h"
+#include "batch.h"
+#include "sweep.h"
+#include "simd.h"
 
 namespace neighbors {
     /** A neighborhood returns a sequence of points "around" a given point. */
     class Neighborhood
     {
         public:
-            Neighborhood( const point_t & pmin_, const point_t & pmax_) : pmin(pmin_), pmax(pmax_) {}
+            Neighborhood( const grid_t & grid_) : grid(grid_) {}
             neighbors_t operator()(const point_t & p) {return call(p);}
+            const grid_t grid;
         protected:
-            const point_t & pmin, pmax;
             virtual neighbors_t call(const point_t & p) = 0;
     };
 
@@ -28,15 +31,12 @@ namespace neighbors {
     class quad_grid : public Neighborhood
     {
         public:
-            quad_grid(double grid_step_, const point_t & pmin, const point_t & pmax) : Neighborhood(pmin,pmax), grid_step(grid_step_) {}
+            quad_grid(const grid_t & grid_) : Neighborhood(grid_) {}
         protected:
-            double grid_step;
             virtual neighbors_t call(const point_t & p)
             {
-                // neighborhood (list) of relative locations (vector)
-                // Should be given in [clockwise] order.
-                std::vector<point_t> directions{{1,0},{0,-1},{-1,0},{0,1}};
-                return neighbors_grid(p,grid_step,pmin,pmax,directions);
+                // The stencil holds the relative locations, in [clockwise] order.
+                return neighbors_grid<quad_stencil>(p,grid);
             }
     };
 
@@ -46,13 +46,11 @@ namespace neighbors {
     class octo_grid : public Neighborhood
     {
         public:
-            octo_grid(double grid_step_, const point_t & pmin, const point_t & pmax) : Neighborhood(pmin,pmax),  grid_step(grid_step_) {}
+            octo_grid(const grid_t & grid_) : Neighborhood(grid_) {}
         protected:
-            double grid_step;
             virtual neighbors_t call(const point_t & p)
             {
-                std::vector<point_t> directions{{1,0},{1,-1},{0,-1},{-1,-1},{-1,0},{-1,1},{0,1},{1,1}};
-                return neighbors_grid(p,grid_step,pmin,pmax,directions);
+                return neighbors_grid<octo_stencil>(p,grid);
             }
     };
 }
@@ -91,6 +89,39 @@ namespace transit {
                 return transit_in_simplex(p,neighbors,costs,eps);
             }
     };
+
+    /** Compute the exact minimal transition on a boundary discretized as segments. */
+    class in_simplex_exact : public HopfLax
+    {
+        protected:
+            virtual double call(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
+            {
+                return transit_in_simplex_exact(p,neighbors,costs);
+            }
+    };
+
+    /** Same as on_edge, vectorized with the best kernels of the CPU (see simd.h). */
+    class on_edge_simd : public HopfLax
+    {
+        protected:
+            virtual double call(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
+            {
+                return transit_on_edge_simd(p,neighbors,costs);
+            }
+    };
+
+    /** Same as in_simplex, vectorized with the best kernels of the CPU (see simd.h). */
+    class in_simplex_simd : public HopfLax
+    {
+        public:
+            in_simplex_simd( double epsilon ) : eps(epsilon) {assert(0 < epsilon and epsilon < 1);}
+        protected:
+            double eps;
+            virtual double call(const point_t & p, const neighbors_t & neighbors, const costs_t & costs)
+            {
+                return transit_in_simplex_simd(p,neighbors,costs,eps);
+            }
+    };
 }
 
 /** An algorithm is a combination of a neighborhood and an Hopf-Lax operator. */
@@ -101,13 +132,40 @@ class algo
         transit::HopfLax & transit;
     public:
         algo(neighbors::Neighborhood & neighbors_, transit::HopfLax & hl) : neighbors(neighbors_), transit(hl) {}
-        virtual costs_t operator()(point_t seed, unsigned int iterations)
+        //! If progress is not null, the progress is printed on it.
+        virtual costs_t operator()(point_t seed, unsigned int iterations, std::ostream * progress = &std::cout)
+        {
+            return algo_run(this->neighbors.grid, seed, iterations, std::ref(this->neighbors), std::ref(this->transit), nullptr, progress);
+        }
+        virtual labeled_costs_t operator()(const std::vector<seed_t> & seeds, unsigned int iterations, std::ostream * progress = &std::cout)
+        {
+            return algo_run(this->neighbors.grid, seeds, iterations, std::ref(this->neighbors), std::ref(this->transit), nullptr, progress);
+        }
+        //! The cost from the seed to the target only (see algo_goal).
+        virtual goal_cost_t goal(point_t seed, point_t target, unsigned int iterations, double heuristic_scale = 1)
+        {
+            return algo_goal(this->neighbors.grid, seed, target, iterations, std::ref(this->neighbors), std::ref(this->transit), heuristic_scale);
+        }
+};
+
+/** The same combination, computed by sweeping across the grid instead of propagating a front.
+
+    The iterations are then the maximum number of sweeps. */
+class sweeping : public algo
+{
+    public:
+        sweeping(neighbors::Neighborhood & neighbors_, transit::HopfLax & hl) : algo(neighbors_, hl) {}
+        // Several labelled seeds are still propagated by a front.
+        using algo::operator();
+        //! Sweeping prints no progress.
+        virtual costs_t operator()(point_t seed, unsigned int iterations, std::ostream * = &std::cout)
         {
-            return algo_run(seed, iterations, std::ref(this->neighbors), std::ref(this->transit));
+            return sweep_run(this->neighbors.grid, seed, iterations, std::ref(this->neighbors), std::ref(this->transit));
         }
 };
 
 
+#ifndef ALGOPATTERN_NO_MAIN
 int main()
 {
     point_t seed; x(seed)= 0;y(seed)= 0;
@@ -122,11 +180,14 @@ int main()
     double eps = 1/100.0;
 
     // Instanciate 2 different functors for each function of the algorithm.
-    neighbors::quad_grid four (step, pmin, pmax);
-    neighbors::octo_grid eight(step, pmin, pmax);
+    grid_t grid(pmin, pmax, step);
+
+    neighbors::quad_grid four (grid);
+    neighbors::octo_grid eight(grid);
 
     transit::on_edge graph;
     transit::in_simplex mesh(eps);
+    transit::in_simplex_exact exact;
 
     // Instanciate the 2*2 possible algo.
 
@@ -138,23 +199,69 @@ int main()
     std::cout << "Dijkstra, 4 neighbors" << std::endl;
     costs_t cd4 = dijkstra4(seed, maxit);
     std::cout << std::endl;
-    grid_print(cd4, pmin, pmax, step);
+    grid_print(cd4);
 
     algo fast_marching4(four,mesh);
     std::cout << "Fast marching, 4 neighbors" << std::endl;
     costs_t cfm4 = fast_marching4(seed, maxit);
     std::cout << std::endl;
-    grid_print(cfm4, pmin, pmax, step);
+    grid_print(cfm4);
+
+    algo exact_fast_marching4(four,exact);
+    std::cout << "Exact fast marching, 4 neighbors" << std::endl;
+    costs_t cxfm4 = exact_fast_marching4(seed, maxit);
+    std::cout << std::endl;
+    grid_print(cxfm4);
 
     algo dijkstra8(eight,graph);
     std::cout << "Dijkstra, 8 neighbors" << std::endl;
     costs_t cd8 = dijkstra8(seed, maxit);
     std::cout << std::endl;
-    grid_print(cd8, pmin, pmax, step);
+    grid_print(cd8);
+
+    std::vector<seed_t> seeds{ {{0,0},0}, {{10,10},0}, {{12,-3},2} };
+    std::cout << "Dijkstra, 8 neighbors, 3 seeds" << std::endl;
+    labeled_costs_t lcd8 = dijkstra8(seeds, maxit);
+    std::cout << std::endl;
+    grid_print(lcd8.costs);
+    labels_print(lcd8.labels, lcd8.costs.grid());
 
     algo fast_marching8(eight,mesh);
     std::cout << "Fast marching, 8 neighbors" << std::endl;
     costs_t cfm8 = fast_marching8(seed, maxit);
     std::cout << std::endl;
-    grid_print(cfm8, pmin, pmax, step);
+    grid_print(cfm8);
+
+    algo exact_fast_marching8(eight,exact);
+    std::cout << "Exact fast marching, 8 neighbors" << std::endl;
+    costs_t cxfm8 = exact_fast_marching8(seed, maxit);
+    std::cout << std::endl;
+    grid_print(cxfm8);
+
+    point_t target = make_point(10,10);
+    goal_cost_t gxfm8 = exact_fast_marching8.goal(seed, target, maxit, simplex_heuristic_scale<octo_stencil>());
+    std::cout << "A* exact fast marching, 8 neighbors, to (10,10): " << gxfm8.cost << " (" << gxfm8.expanded << " accepted, vs. " << cxfm8.at(target) << ")" << std::endl;
+    std::cout << std::endl;
+
+    transit::in_simplex_simd vmesh(eps);
+    algo vectorized_fast_marching8(eight,vmesh);
+    std::cout << "Fast marching, 8 neighbors, vectorized (" << simd_kernels().name << ")" << std::endl;
+    costs_t cvfm8 = vectorized_fast_marching8(seed, maxit);
+    std::cout << std::endl;
+    grid_print(cvfm8);
+
+    sweeping fast_sweeping8(eight,exact);
+    std::cout << "Fast sweeping, 8 neighbors" << std::endl;
+    costs_t csw8 = fast_sweeping8(seed, /*sweeps=*/10);
+    grid_print(csw8);
+
+    std::vector<query_t> queries{ {{0,0},maxit}, {{10,10},maxit}, {{12,-3},maxit}, {{-5,15},maxit} };
+    work_stealing_pool pool(2);
+    std::cout << "Batch of Dijkstra, 8 neighbors" << std::endl;
+    std::vector<costs_t> batch = batch_run(grid, queries, pool, batch_propagation(std::ref(eight), std::ref(graph)));
+    for( size_t q = 0; q < queries.size(); ++q ) {
+        std::cout << "from (" << x(queries[q].seed) << "," << y(queries[q].seed) << ") to (5,5): " << batch[q].at(make_point(5,5)) << std::endl;
+    }
+    std::cout << std::endl;
 }
+#endif // ALGOPATTERN_NO_MAIN
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <thread>
+#include <array>
+
+#include "code.h"
+
+/** \defgroup Sweep Fast sweeping, an alternative to the propagation of a front.
+
+    Instead of accepting one node after the other, the fast sweeping method
+    updates all the nodes of the grid in a fixed order (Gauss-Seidel iterations),
+    alternating between the four diagonal orderings of the grid,
+    until no cost decreases anymore.
+    Each node is updated with the same neighborhood and transit functions as algo_run,
+    so that any composition of those operators can be used.
+
+    The number of sweeps needed does not depend on the size of the grid,
+    but on the number of times the characteristics change direction,
+    which makes it efficient on large domains with few obstacles.
+
+  @{
+*/
+
+/** The four orderings of the grid, as directions along x and y. */
+const std::array<offset_t,4> sweep_orderings{{ {1,1}, {-1,1}, {-1,-1}, {1,-1} }};
+
+/** Update all the nodes of the grid once, in the given ordering.
+
+  \return True if at least one cost decreased.
+ */
+template<typename N, typename T>
+bool sweep_once(costs_t & costs, const offset_t & ordering, N & neighbors, T & transit)
+{
+    const grid_t & grid = costs.grid();
+    const long w = static_cast<long>(grid.width);
+    const long h = static_cast<long>(grid.height);
+    bool changed = false;
+
+    for( long jj = 0; jj < h; ++jj ) {
+        long j = ordering.second > 0 ? jj : h-1-jj;
+        for( long ii = 0; ii < w; ++ii ) {
+            long i = ordering.first > 0 ? ii : w-1-ii;
+            point_t p = grid.point(i,j);
+            neighbors_t around = neighbors(p);
+            // Nodes which are not yet reached cannot be updated.
+            if( std::none_of(begin(around), end(around), [&costs](const point_t& n){return has_cost(n,costs);}) ) {
+                continue;
+            }
+            size_t idx = grid.index(i,j);
+            double c = transit(p, around, costs);
+            if( c < costs[idx] ) {
+                costs[idx] = c;
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+/** Compute the costs from the given seed, by sweeping across the grid.
+
+  \param grid The grid on which the costs are computed.
+  \param seed The point with NULL cost.
+  \param sweeps The maximum number of sweeps, each of them going through the four orderings.
+  \return The costs grid: <points index> => <cost>
+*/
+inline costs_t sweep_run(
+        const grid_t & grid,
+        point_t seed,
+        unsigned int sweeps,
+        std::function< neighbors_t(const point_t&) > neighbors,
+        std::function< double(const point_t &, const neighbors_t &, const costs_t &) > transit
+    )
+{
+    costs_t costs(grid);
+    costs[seed] = 0;
+
+    bool changed = true;
+    for( unsigned int s = 0; s < sweeps and changed; ++s ) {
+        changed = false;
+        for( const offset_t & ordering : sweep_orderings ) {
+            // Note: do not short-circuit the sweep.
+            changed = sweep_once(costs, ordering, neighbors, transit) or changed;
+        }
+    }
+    return costs;
+}
+
+/** Compute the costs from the given seed, by sweeping the four orderings in parallel.
+
+  Each ordering is swept by its own thread, on its own copy of the current costs,
+  and the copies are then merged by keeping the minimal cost of each node.
+  This needs more sweeps than sweep_run, but each one runs four times more in parallel.
+  The given neighborhood and transit are called concurrently and should thus be thread-safe.
+
+  \param grid The grid on which the costs are computed.
+  \param seed The point with NULL cost.
+  \param sweeps The maximum number of parallel sweeps.
+  \return The costs grid: <points index> => <cost>
+*/
+inline costs_t sweep_run_parallel(
+        const grid_t & grid,
+        point_t seed,
+        unsigned int sweeps,
+        std::function< neighbors_t(const point_t&) > neighbors,
+        std::function< double(const point_t &, const neighbors_t &, const costs_t &) > transit
+    )
+{
+    costs_t costs(grid);
+    costs[seed] = 0;
+
+    bool changed = true;
+    for( unsigned int s = 0; s < sweeps and changed; ++s ) {
+        std::vector<costs_t> copies(sweep_orderings.size(), costs);
+        std::array<bool,4> changes{{false,false,false,false}};
+
+        std::vector<std::thread> threads;
+        for( size_t o = 0; o < sweep_orderings.size(); ++o ) {
+            threads.push_back( std::thread( [&,o](){
+                changes[o] = sweep_once(copies[o], sweep_orderings[o], neighbors, transit);
+            }));
+        }
+        for( std::thread & t : threads ) {
+            t.join();
+        }
+
+        changed = std::find(begin(changes), end(changes), true) != end(changes);
+        for( size_t idx = 0; idx < costs.size(); ++idx ) {
+            for( const costs_t & copy : copies ) {
+                costs[idx] = std::min(costs[idx], copy.at(idx));
+            }
+        }
+    }
+    return costs;
+}
+
+/** @} Sweep */
@@ -0,0 +1,106 @@
+/** Check that propagating a front does not allocate on the heap.
+
+    The global allocation operators are replaced by counting ones.
+    Each composition is run once in a scratch, to size the front's storage,
+    then run again in the same (reset) scratch, which should not allocate anything.
+    Runs from other seeds in a workspace should not allocate either.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <queue>
+#include <cassert>
+#include <functional>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+
+#include "code.h"
+#include "batch.h"
+#include "workspace.h"
+
+std::atomic<size_t> allocations(0);
+
+void* operator new(size_t size)
+{
+    allocations++;
+    void* p = std::malloc(size);
+    if( not p ) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+using neighbors_f = std::function< neighbors_t(const point_t&) >;
+using transit_f = std::function< double(const point_t &, const neighbors_t &, const costs_t &) >;
+
+template<typename Front>
+bool check(const std::string & name, const grid_t & grid, neighbors_f neighbors, transit_f transit)
+{
+    scratch_t<Front> scratch(grid);
+    auto run = batch_propagation<Front>(neighbors, transit);
+    query_t query{grid.point(grid.width/3, grid.height/4), static_cast<unsigned int>(grid.size())};
+
+    run(scratch, query);
+    scratch.reset();
+
+    size_t before = allocations;
+    run(scratch, query);
+    size_t count = allocations - before;
+
+    std::cout << name << ": " << count << " allocations" << std::endl;
+    return count == 0;
+}
+
+//! Run from several seeds in the same workspace, after a first run from each of them (which sizes the front's storage).
+bool check_workspace(const std::string & name, const grid_t & grid)
+{
+    workspace_t<> workspace;
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+    std::vector<point_t> seeds;
+    for( size_t j = 0; j < grid.height; j += 5 ) {
+        seeds.push_back(grid.point(grid.width/2, j));
+    }
+    for( const point_t & seed : seeds ) {
+        algo_run(workspace, grid, seed, grid.size(), eight, transit_in_simplex_exact_of<double,touched_costs>);
+    }
+
+    size_t before = allocations;
+    for( auto seed = seeds.rbegin(); seed != seeds.rend(); ++seed ) {
+        algo_run(workspace, grid, *seed, grid.size(), eight, transit_in_simplex_exact_of<double,touched_costs>);
+    }
+    size_t count = allocations - before;
+
+    std::cout << name << ": " << count << " allocations" << std::endl;
+    return count == 0;
+}
+
+int main()
+{
+    grid_t grid(make_point(-5,-5), make_point(15,15), 1);
+
+    neighbors_f four  = [&grid](const point_t& p) {return neighbors_grid<quad_stencil>(p,grid);};
+    neighbors_f eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+    transit_f graph = transit_on_edge;
+    transit_f mesh  = [](const point_t & p, const neighbors_t & neighbors, const costs_t & costs) {return transit_in_simplex(p,neighbors,costs,1/100.0);};
+    transit_f exact = transit_in_simplex_exact;
+
+    bool ok = true;
+    ok = check<front_t>("Dijkstra, 4 neighbors", grid, four, graph) and ok;
+    ok = check<front_t>("Dijkstra, 8 neighbors", grid, eight, graph) and ok;
+    ok = check<front_t>("Fast marching, 4 neighbors", grid, four, mesh) and ok;
+    ok = check<front_t>("Fast marching, 8 neighbors", grid, eight, mesh) and ok;
+    ok = check<front_t>("Exact fast marching, 8 neighbors", grid, eight, exact) and ok;
+    ok = check<bucket_front<>>("Untidy fast marching, 8 neighbors", grid, eight, exact) and ok;
+    ok = check_workspace("Exact fast marching, 8 neighbors, in a workspace", grid) and ok;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,137 @@
+/** Check the propagation with a memory bounded by the width of the front.
+
+    - Each point should be given exactly once to the sink.
+    - The costs should be the ones of the dense propagation, including on a speed field with unreachable points.
+    - Only a part of the blocks should be held at once.
+    - The file sink should write the same bytes than costs_write.
+  */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cstdio>
+
+#include "code.h"
+#include "speed.h"
+#include "output.h"
+#include "bounded.h"
+#include "expect.h"
+
+//! Gather the tiles in the row-major costs, counting how many times each point is given.
+struct gather_t
+{
+    gather_t(const grid_t & grid) : width(grid.width), costs(grid.width * grid.height), given(grid.width * grid.height, 0) {}
+
+    void operator()(const costs_tile<double> & tile)
+    {
+        for( size_t dj = 0; dj < tile.height; ++dj ) {
+            for( size_t di = 0; di < tile.width; ++di ) {
+                size_t k = (tile.j + dj) * width + tile.i + di;
+                costs[k] = tile.at(di, dj);
+                given[k]++;
+            }
+        }
+    }
+
+    //! Max difference with the dense costs, infinite if some point is not given exactly once.
+    double max_diff(const costs_t & dense) const
+    {
+        const grid_t & grid = dense.grid();
+        double diff = 0;
+        for( size_t j = 0; j < grid.height; ++j ) {
+            for( size_t i = 0; i < grid.width; ++i ) {
+                size_t k = j * width + i;
+                double d = dense.at(grid.index(i,j));
+                if( given[k] != 1 or std::isinf(d) != std::isinf(costs[k]) ) {
+                    return std::numeric_limits<double>::infinity();
+                }
+                if( not std::isinf(d) ) {
+                    diff = std::max(diff, std::abs(d - costs[k]));
+                }
+            }
+        }
+        return diff;
+    }
+
+    size_t width;
+    std::vector<double> costs;
+    std::vector<unsigned int> given;
+};
+
+int main()
+{
+    bool ok = true;
+    // Blocks of 16 points, the last ones being truncated.
+    const unsigned int block_log2 = 4;
+    grid_t grid(make_point(0,0), make_point(149,96), 1);
+    point_t seed = grid.point(10,20);
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+
+    // A wall with a gap, and a closed box.
+    std::vector<float> speeds(grid.width * grid.height, 1);
+    for( size_t j = 10; j < grid.height; ++j ) {
+        speeds[j * grid.width + 70] = 0;
+    }
+    for( size_t k = 0; k <= 10; ++k ) {
+        speeds[(20 + k) * grid.width + 100] = 0;
+        speeds[(20 + k) * grid.width + 110] = 0;
+        speeds[20 * grid.width + 100 + k] = 0;
+        speeds[30 * grid.width + 100 + k] = 0;
+    }
+    speed_field_t field(grid, speeds);
+    auto around = [&grid,&field](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid,field);};
+    auto speed = [&grid,&field](const point_t& p, const neighbors_t& n, const paged_costs<double>& c) {
+        const size_t idx = grid.j(p) * grid.width + grid.i(p);
+        // The obstacles are among the neighborhoods, but are never reached (as in transit_in_simplex_exact_speed).
+        if( not field.passable(idx) ) {
+            return std::numeric_limits<double>::infinity();
+        }
+        return transit_in_simplex_exact_weighted_of(p,n,c,field.slowness(idx));
+    };
+    auto dense_speed = [&field](const point_t& p, const neighbors_t& n, const costs_t& c) {return transit_in_simplex_exact_speed(p,n,c,field);};
+
+    std::streambuf* out = std::cout.rdbuf(nullptr);
+    costs_t graph = algo_run(grid, seed, grid.size(), eight, transit_on_edge);
+    costs_t exact = algo_run(grid, seed, grid.size(), eight, transit_in_simplex_exact);
+    costs_t walled = algo_run(grid, seed, grid.size(), around, dense_speed);
+    std::cout.rdbuf(out);
+    std::cout.clear();
+
+    size_t blocks = ((grid.width + 15) / 16) * ((grid.height + 15) / 16);
+    {
+        gather_t gather(grid);
+        bounded_stats_t stats = bounded_run<double>(grid, seed, eight, transit_on_edge_of<double,paged_costs>, std::ref(gather), block_log2);
+        ok &= expect(gather.max_diff(graph) == 0, "on edges: same costs than the dense propagation");
+        ok &= expect(stats.accepted == grid.width * grid.height, "on edges: all points accepted");
+        std::cout << "     " << stats.peak_blocks << " blocks at most, out of " << blocks << std::endl;
+        ok &= expect(stats.peak_blocks < blocks / 2, "on edges: less than half the blocks held at once");
+    }
+    {
+        gather_t gather(grid);
+        bounded_stats_t stats = bounded_run<double>(grid, seed, eight, transit_in_simplex_exact_of<double,paged_costs>, std::ref(gather), block_log2);
+        ok &= expect(gather.max_diff(exact) < 1e-12, "in simplexes: same costs than the dense propagation");
+        ok &= expect(stats.peak_blocks < blocks / 2, "in simplexes: less than half the blocks held at once");
+    }
+    {
+        gather_t gather(grid);
+        bounded_run<double>(grid, seed, around, speed, std::ref(gather), block_log2);
+        ok &= expect(gather.max_diff(walled) < 1e-12, "on a speed field: same costs than the dense propagation");
+    }
+    {
+        const std::string path = "test_bounded.npy";
+        bounded_run<double>(grid, seed, eight, transit_in_simplex_exact_of<double,paged_costs>, tile_file_sink<double>(grid, path), block_log2);
+        std::ifstream in(path, std::ios::binary);
+        std::ostringstream file;
+        file << in.rdbuf();
+        std::remove(path.c_str());
+        std::ostringstream dense;
+        costs_write<double>(exact, dense);
+        ok &= expect(file.str() == dense.str(), "file sink: same bytes than costs_write");
+    }
+
+    return ok ? 0 : 1;
+}
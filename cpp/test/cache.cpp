@@ -0,0 +1,121 @@
+/** Check the cache of costs fields.
+
+    - On a uniform grid, the views on the canonical field should be the costs computed from each seed.
+    - A larger grid should recompute the canonical field, which then serves the smaller ones.
+    - Grids of other shapes should share the canonical field, once it is large enough for all of them.
+    - The least recently used cache should serve the same costs than the propagation,
+      and evict the least recently used field.
+    - Without capacity, the costs should still be served, but not kept.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#include "code.h"
+#include "speed.h"
+#include "cache.h"
+#include "expect.h"
+
+//! Max difference between the viewed costs and the computed ones.
+double max_diff(const costs_view & view, const costs_t & costs)
+{
+    const grid_t & grid = costs.grid();
+    double diff = 0;
+    for( long j = 0; j < static_cast<long>(grid.height); ++j ) {
+        for( long i = 0; i < static_cast<long>(grid.width); ++i ) {
+            double c = costs.at(grid.index(i,j));
+            double v = view.at(i,j);
+            if( c != v ) {
+                diff = std::max(diff, std::isinf(c) or std::isinf(v) ? std::numeric_limits<double>::infinity() : std::abs(c - v));
+            }
+        }
+    }
+    return diff;
+}
+
+int main()
+{
+    bool ok = true;
+    grid_t grid(make_point(-5,-3), make_point(35,25), 1);
+    grid_t large(make_point(-5,-3), make_point(45,25), 1);
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+    std::vector<point_t> seeds{grid.point(0,0), grid.point(20,14), grid.point(40,3), grid.point(7,28), grid.point(40,28)};
+
+    costs_cache cache(2);
+    const cache_key_t graph{"octo", "on_edge", 0};
+    const cache_key_t exact{"octo", "in_simplex_exact", 0};
+    std::streambuf* out = std::cout.rdbuf(nullptr);
+    double graph_diff = 0;
+    double exact_diff = 0;
+    for( const point_t & seed : seeds ) {
+        graph_diff = std::max(graph_diff, max_diff(cache.uniform<octo_stencil>(graph, grid, seed, transit_on_edge),
+                                                   algo_run(grid, seed, grid.size(), eight, transit_on_edge)));
+        exact_diff = std::max(exact_diff, max_diff(cache.uniform<octo_stencil>(exact, grid, seed, transit_in_simplex_exact),
+                                                   algo_run(grid, seed, grid.size(), eight, transit_in_simplex_exact)));
+    }
+    std::cout.rdbuf(out);
+    std::cout.clear();
+    ok &= expect(graph_diff == 0, "uniform on edges: views are the computed costs");
+    ok &= expect(exact_diff < 1e-9, "uniform in simplexes: views are the computed costs");
+    ok &= expect(cache.stats().misses == 2 and cache.stats().canonical_hits == 2 * seeds.size() - 2, "uniform: a single field per key");
+
+    cache.uniform<octo_stencil>(graph, large, large.point(50,0), transit_on_edge);
+    cache.uniform<octo_stencil>(graph, grid, seeds[1], transit_on_edge);
+    ok &= expect(cache.stats().misses == 3 and cache.stats().canonical_hits == 2 * seeds.size() - 1, "uniform: a larger grid recomputes the field, which serves the smaller ones");
+
+    // Alternating a wide and a tall grid.
+    costs_cache shapes;
+    grid_t wide(make_point(0,0), make_point(99,9), 1);
+    grid_t tall(make_point(0,0), make_point(9,99), 1);
+    out = std::cout.rdbuf(nullptr);
+    double shapes_diff = 0;
+    for( unsigned int q = 0; q < 6; ++q ) {
+        const grid_t & g = q % 2 ? tall : wide;
+        point_t seed = g.point(static_cast<long>(q * 7 % g.width), static_cast<long>(q * 3 % g.height));
+        auto around = [&g](const point_t& p) {return neighbors_grid<octo_stencil>(p,g);};
+        shapes_diff = std::max(shapes_diff, max_diff(shapes.uniform<octo_stencil>(graph, g, seed, transit_on_edge),
+                                                     algo_run(g, seed, g.size(), around, transit_on_edge)));
+    }
+    std::cout.rdbuf(out);
+    std::cout.clear();
+    ok &= expect(shapes_diff == 0, "uniform, mixed shapes: views are the computed costs");
+    ok &= expect(shapes.stats().misses == 2 and shapes.stats().canonical_hits == 4, "uniform, mixed shapes: the field grows once, then serves both shapes");
+
+    // A wall with a gap.
+    std::vector<float> speeds(grid.width * grid.height, 1);
+    for( size_t j = 5; j < grid.height; ++j ) {
+        speeds[j * grid.width + 20] = 0;
+    }
+    speed_field_t field(grid, speeds);
+    auto around = [&grid,&field](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid,field);};
+    auto speed = [&field](const point_t& p, const neighbors_t& n, const costs_t& c) {return transit_in_simplex_exact_speed(p,n,c,field);};
+    const cache_key_t walled{"octo_wall", "in_simplex_exact_speed", 0};
+
+    cache_stats_t before = cache.stats();
+    out = std::cout.rdbuf(nullptr);
+    costs_t c0 = algo_run(grid, seeds[0], grid.size(), around, speed);
+    costs_t c3 = algo_run(grid, seeds[3], grid.size(), around, speed);
+    std::cout.rdbuf(out);
+    std::cout.clear();
+    bool same = max_diff(cache.any(walled, grid, seeds[0], grid.size(), around, speed), c0) == 0;
+    same &= max_diff(cache.any(walled, grid, seeds[3], grid.size(), around, speed), c3) == 0;
+    same &= max_diff(cache.any(walled, grid, seeds[0], grid.size(), around, speed), c0) == 0;
+    ok &= expect(same, "any domain: the cached costs are the computed ones");
+    ok &= expect(cache.stats().misses == before.misses + 2 and cache.stats().lru_hits == 1, "any domain: a hit on the same seed");
+    // seeds[3] is the least recently used one.
+    cache.any(walled, grid, seeds[2], grid.size(), around, speed);
+    cache.any(walled, grid, seeds[0], grid.size(), around, speed);
+    cache.any(walled, grid, seeds[3], grid.size(), around, speed);
+    ok &= expect(cache.stats().misses == before.misses + 4 and cache.stats().lru_hits == 2, "any domain: the least recently used field is evicted");
+    std::cout << "     hit rate: " << cache.stats().hit_rate() << std::endl;
+
+    costs_cache uncached(0);
+    same = max_diff(uncached.any(walled, grid, seeds[0], grid.size(), around, speed), c0) == 0;
+    same &= max_diff(uncached.any(walled, grid, seeds[0], grid.size(), around, speed), c0) == 0;
+    ok &= expect(same and uncached.size() == 0 and uncached.stats().misses == 2, "any domain, without capacity: the costs are computed, not kept");
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+/** Print the outcome of a check, and return it (e.g. ok &= expect(..., "what is checked")). */
+inline bool expect(bool ok, const std::string & what)
+{
+    std::cout << (ok ? "OK   " : "FAIL ") << what << std::endl;
+    return ok;
+}
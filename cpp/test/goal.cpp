@@ -0,0 +1,76 @@
+/** Check the point-to-point A* queries against full propagations.
+
+    - On edges, with a unit heuristic scale, the cost of the goal should be the one of the full propagation.
+    - In simplexes, with the scale of simplex_heuristic_scale, the cost should also be the one of the full propagation.
+    - The queries should accept fewer points than the full propagation.
+    - Queries in a reused workspace, and from the policies composition, should give the same costs.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#define ALGOPATTERN_NO_MAIN
+#include "policies.cpp"
+#include "expect.h"
+
+int main()
+{
+    bool ok = true;
+    grid_t grid(make_point(-5,-5), make_point(15,15), 1);
+    point_t seed = make_point(0,0);
+    std::vector<point_t> goals{make_point(10,3), make_point(-4,13), make_point(15,-5), make_point(7,12), make_point(1,0)};
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+    const double scale = simplex_heuristic_scale<octo_stencil>();
+
+    ok &= expect(simplex_heuristic_scale<quad_stencil>() == 0, "4 neighbors: the heuristic of the simplexes vanishes");
+    ok &= expect(std::abs(scale - std::sqrt(2)/2) < 1e-9, "8 neighbors: the heuristic of the simplexes is scaled by cos(45°)");
+
+    using transit_f = std::function< double(const point_t &, const neighbors_t &, const costs_t &) >;
+    using touched_transit_f = std::function< double(const point_t &, const neighbors_t &, const touched_costs<double> &) >;
+    struct transit_case_t {std::string name; transit_f plain; touched_transit_f touched; double scale;};
+    std::vector<transit_case_t> transits{
+        {"on edges", transit_on_edge, transit_on_edge_of<double,touched_costs>, 1},
+        {"in simplexes", [](const point_t & p, const neighbors_t & n, const costs_t & c) {return transit_in_simplex(p,n,c,1/10.0);},
+                         [](const point_t & p, const neighbors_t & n, const touched_costs<double> & c) {return transit_in_simplex_of(p,n,c,1/10.0);}, scale},
+        {"in simplexes, exact", transit_in_simplex_exact, transit_in_simplex_exact_of<double,touched_costs>, scale}
+    };
+
+    workspace_t<> workspace;
+    for( auto & t : transits ) {
+        std::streambuf* out = std::cout.rdbuf(nullptr);
+        costs_t full = algo_run(grid, seed, grid.size(), eight, t.plain);
+        std::cout.rdbuf(out);
+        std::cout.clear();
+        double max_rel = 0;
+        bool fewer = true;
+        bool same = true;
+        for( const point_t & goal : goals ) {
+            goal_cost_t g = algo_goal(grid, seed, goal, grid.size(), eight, t.plain, t.scale);
+            goal_cost_t w = algo_goal(workspace, grid, seed, goal, grid.size(), eight, t.touched, t.scale);
+            max_rel = std::max(max_rel, std::abs(g.cost - full.at(goal)) / full.at(goal));
+            fewer &= g.expanded < grid.width * grid.height;
+            same &= w.cost == g.cost and w.expanded == g.expanded;
+        }
+        ok &= expect(max_rel < 1e-12, t.name + ": the cost of the goal is the one of the full propagation");
+        ok &= expect(fewer, t.name + ": fewer points are accepted");
+        ok &= expect(same, t.name + ": same queries in a workspace");
+    }
+
+    algo<neighbors::octo_grid<1, -5, -5, 15, 15>, transit::in_simplex_exact> exact;
+    workspace_t<> policies_workspace;
+    std::streambuf* out = std::cout.rdbuf(nullptr);
+    costs_t full = exact(seed, grid.size());
+    std::cout.rdbuf(out);
+    std::cout.clear();
+    bool same = true;
+    for( const point_t & goal : goals ) {
+        same &= std::abs(exact.goal(seed, goal, grid.size(), scale).cost - full.at(goal)) < 1e-12 * full.at(goal);
+        same &= exact.goal(policies_workspace, seed, goal, grid.size(), scale).cost == exact.goal(seed, goal, grid.size(), scale).cost;
+    }
+    ok &= expect(same, "policies: the cost of the goal is the one of the full propagation, in a workspace or not");
+
+    return ok ? 0 : 1;
+}
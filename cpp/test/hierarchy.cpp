@@ -0,0 +1,93 @@
+/** Check the coarse-to-fine queries against the full resolution A*.
+
+    - On edges, the cost should never be below the one of the full resolution, and close to it.
+    - In simplexes, the cost should be close to the one of the full resolution.
+    - Only a part of the fine grid should be searched, and take memory, unless the coarse grid misses a thin wall.
+    - An unreachable goal should have an infinite cost.
+    - Blocked coarse points near the seed should be skipped, and a coarse grid entirely blocked
+      should fall back to the whole fine grid.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#include "code.h"
+#include "hierarchy.h"
+#include "expect.h"
+
+int main()
+{
+    bool ok = true;
+    grid_t grid(make_point(0,0), make_point(300,200), 1);
+    point_t seed = grid.point(10,20);
+    point_t goal = grid.point(283,171);
+
+    using transit_f = std::function< double(const point_t &, const neighbors_t &, const costs_t &) >;
+    struct transit_case_t {std::string name; transit_f full; corridor_transit_f corridor;};
+    std::vector<transit_case_t> transits{
+        {"on edges", transit_on_edge, transit_on_edge_of<double,corridor_costs>},
+        {"in simplexes", transit_in_simplex_exact, transit_in_simplex_exact_of<double,corridor_costs>}
+    };
+    // A thick wall, from the top down to a gap, then another one from the bottom up.
+    auto walls = [&grid] (const point_t & p) {
+        long i = grid.i(p), j = grid.j(p);
+        return not ((100 <= i and i < 116 and j > 40) or (200 <= i and i < 216 and j < 160));
+    };
+    // A thin wall between the coarse points, with a gap.
+    auto thin = [&grid] (const point_t & p) {return grid.i(p) != 150 or grid.j(p) > 180;};
+    // A closed wall.
+    auto closed = [&grid] (const point_t & p) {return grid.i(p) != 150;};
+
+    struct domain_t {std::string name; std::function< bool(const point_t &) > passable;};
+    std::vector<domain_t> domains{{"uniform", nullptr}, {"thick walls", walls}, {"thin wall", thin}};
+
+    for( auto & t : transits ) {
+        for( auto & d : domains ) {
+            auto free = [&d] (const point_t & p) {return not d.passable or d.passable(p);};
+            auto neighbors = [&] (const point_t & p) {
+                return neighbors_grid_if<octo_stencil>(p, grid, [&] (size_t idx) {return free(grid.point(idx));});
+            };
+            goal_cost_t full = algo_goal(grid, seed, goal, grid.size(), neighbors, t.full);
+
+            for( unsigned int factor : {4, 8} ) {
+                std::string what = t.name + ", " + d.name + ", factor " + std::to_string(factor);
+                hierarchy_cost_t h = coarse_to_fine<octo_stencil>(grid, seed, goal, t.corridor, factor, 2, d.passable);
+                double rel = (h.cost - full.cost) / full.cost;
+                ok &= expect(std::abs(rel) < 0.02, what + ": close to the full resolution");
+                if( t.name == "on edges" ) {
+                    ok &= expect(rel > -1e-12, what + ": not below the full resolution");
+                }
+                if( d.name != "thin wall" ) {
+                    ok &= expect(not h.fallback and h.fine_points < grid.size(), what + ": searches a part of the grid");
+                    ok &= expect(h.fine_bytes < grid.size() * sizeof(double), what + ": takes less memory than the costs of the grid");
+                }
+            }
+        }
+    }
+
+    hierarchy_cost_t h = coarse_to_fine<octo_stencil>(grid, seed, goal, transit_on_edge_of<double,corridor_costs>, 8, 2, closed);
+    ok &= expect(h.fallback and std::isinf(h.cost), "unreachable goal");
+
+    grid_t small(make_point(0,0), make_point(99,99), 1);
+    point_t from = small.point(11,11);
+    point_t to = small.point(90,90);
+    auto small_neighbors = [&small] (const point_t & p) {return neighbors_grid<octo_stencil>(p, small);};
+    goal_cost_t small_full = algo_goal(small, from, to, small.size(), small_neighbors, transit_on_edge);
+    // The coarse point nearest to the seed, (8,8), is blocked.
+    auto blocked_near = [&small] (const point_t & p) {return small.i(p) != 8 or small.j(p) != 8;};
+    h = coarse_to_fine<octo_stencil>(small, from, to, transit_on_edge_of<double,corridor_costs>, 8, 2, blocked_near);
+    ok &= expect(not h.fallback and std::abs(h.cost - small_full.cost) < 1e-9, "blocked coarse point nearest to the seed");
+    // Every coarse point is blocked, but not the fine points between them.
+    auto blocked_coarse = [&small] (const point_t & p) {return small.i(p) % 8 != 0 or small.j(p) % 8 == 3;};
+    auto blocked_neighbors = [&] (const point_t & p) {
+        return neighbors_grid_if<octo_stencil>(p, small, [&] (size_t idx) {return blocked_coarse(small.point(idx));});
+    };
+    goal_cost_t blocked_full = algo_goal(small, from, to, small.size(), blocked_neighbors, transit_on_edge);
+    h = coarse_to_fine<octo_stencil>(small, from, to, transit_on_edge_of<double,corridor_costs>, 8, 2, blocked_coarse);
+    ok &= expect(h.fallback and std::abs(h.cost - blocked_full.cost) < 1e-9, "blocked coarse grid: falls back to the fine grid");
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+/** Check the storage layouts of the grids.
+
+    - Indices should be a bijection between the points and a part of the storage, and coords should invert them.
+    - Propagations should give the same costs whatever the layout,
+      including on a speed field, which stays in row-major order.
+    - Written costs should be the same whatever the layout.
+    - The padding of the tiled layouts should stay small on elongated grids.
+  */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#include "code.h"
+#include "speed.h"
+#include "output.h"
+#include "expect.h"
+
+//! Max difference between the costs of the same points.
+double max_diff(const costs_t & a, const costs_t & b)
+{
+    const grid_t & grid = a.grid();
+    double diff = 0;
+    for( long j = 0; j < static_cast<long>(grid.height); ++j ) {
+        for( long i = 0; i < static_cast<long>(grid.width); ++i ) {
+            double ca = a.at(grid.index(i,j));
+            double cb = b.at(b.grid().index(i,j));
+            if( ca != cb ) {
+                diff = std::max(diff, std::isinf(ca) or std::isinf(cb) ? std::numeric_limits<double>::infinity() : std::abs(ca - cb));
+            }
+        }
+    }
+    return diff;
+}
+
+int main()
+{
+    bool ok = true;
+    // Neither square, nor a multiple of the tiles.
+    const point_t pmin = make_point(-3,-2);
+    const point_t pmax = make_point(37,20);
+    grid_t rows(pmin, pmax, 1);
+    std::vector< std::pair<std::string, grid_t> > layouts{
+        {"tiled 4x4", grid_t(pmin, pmax, 1, layout_t::tiled, 2)},
+        {"tiled 16x16", grid_t(pmin, pmax, 1, layout_t::tiled)},
+        {"morton in 8x8 tiles", grid_t(pmin, pmax, 1, layout_t::morton, 3)},
+        {"morton", grid_t(pmin, pmax, 1, layout_t::morton)}
+    };
+
+    // A wall with a gap.
+    std::vector<float> speeds(rows.width * rows.height, 1);
+    for( size_t j = 3; j < rows.height; ++j ) {
+        speeds[j * rows.width + 20] = 0;
+    }
+    speed_field_t field(rows, speeds);
+    point_t seed = rows.point(5,7);
+
+    auto run = [&] (const grid_t & grid, bool exact, bool walled) {
+        auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+        auto around = [&grid,&field](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid,field);};
+        auto speed = [&field](const point_t& p, const neighbors_t& n, const costs_t& c) {return transit_in_simplex_exact_speed(p,n,c,field);};
+        std::streambuf* out = std::cout.rdbuf(nullptr);
+        costs_t costs = walled ? algo_run(grid, seed, grid.size(), around, speed)
+                      : exact  ? algo_run(grid, seed, grid.size(), eight, transit_in_simplex_exact)
+                      :          algo_run(grid, seed, grid.size(), eight, transit_on_edge);
+        std::cout.rdbuf(out);
+        std::cout.clear();
+        return costs;
+    };
+    costs_t graph = run(rows, false, false);
+    costs_t exact = run(rows, true, false);
+    costs_t walled = run(rows, true, true);
+    std::ostringstream written;
+    costs_write<double>(exact, written);
+
+    for( auto & l : layouts ) {
+        const grid_t & grid = l.second;
+        std::vector<bool> used(grid.size(), false);
+        bool bijective = grid.size() >= rows.size();
+        for( long j = 0; j < static_cast<long>(grid.height); ++j ) {
+            for( long i = 0; i < static_cast<long>(grid.width); ++i ) {
+                size_t idx = grid.index(i,j);
+                bijective &= idx < grid.size() and not used[idx] and grid.coords(idx) == std::make_pair(i,j)
+                             and grid.row_major(idx) == rows.index(i,j);
+                used[idx] = true;
+            }
+        }
+        ok &= expect(bijective, l.first + ": indices are a bijection");
+
+        costs_t exact_l = run(grid, true, false);
+        ok &= expect(max_diff(run(grid, false, false), graph) == 0, l.first + ": same costs on edges");
+        ok &= expect(max_diff(exact_l, exact) < 1e-12, l.first + ": same costs in simplexes");
+        ok &= expect(max_diff(run(grid, true, true), walled) < 1e-12, l.first + ": same costs on a speed field");
+
+        std::ostringstream written_l;
+        costs_write<double>(exact_l, written_l);
+        ok &= expect(written_l.str() == written.str(), l.first + ": same written costs");
+    }
+
+    for( layout_t layout : {layout_t::tiled, layout_t::morton} ) {
+        grid_t elongated(make_point(0,0), make_point(9999,99), 1, layout);
+        ok &= expect(elongated.size() < 2 * elongated.width * elongated.height,
+                     std::string(layout == layout_t::tiled ? "tiled" : "morton") + ": small padding on an elongated grid");
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+/** Check the propagation on grids of any dimension.
+
+    - In 2D, the axis and cube stencils should give the same costs than the 4 and 8 neighbors,
+      on edges and in simplexes.
+    - The stencils should have the expected number of neighbors and simplex faces.
+    - In 3D, the costs along the axes should be exact,
+      and the tetrahedral updates should be closer to the euclidean distance than the edges.
+    - The policies composition should give the same costs on a grid of dimension D.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#define ALGOPATTERN_NO_MAIN
+#include "policies.cpp"
+#include "expect.h"
+
+//! Max difference between the costs of a 2D grid_n and the ones of the same grid_t.
+double max_diff(const costs_n<2> & a, const costs_t & b)
+{
+    double diff = 0;
+    for( size_t i = 0; i < a.size(); ++i ) {
+        diff = std::max(diff, std::abs(a.at(i) - b.at(i)));
+    }
+    return diff;
+}
+
+//! Max difference with the euclidean distance to the seed.
+template<size_t D>
+double max_error(const costs_n<D> & costs, const point_n<D> & seed)
+{
+    double error = 0;
+    for( size_t i = 0; i < costs.size(); ++i ) {
+        error = std::max(error, std::abs(costs.at(i) - distance(costs.grid().point(i), seed)));
+    }
+    return error;
+}
+
+int main()
+{
+    bool ok = true;
+
+    // 2D, against the original grid.
+    grid_t grid(make_point(-5,-5), make_point(15,12), 0.5);
+    grid_n<2> grid2({{-5,-5}}, {{15,12}}, 0.5);
+    ok &= expect(grid2.size() == grid.size() and grid2.extents[0] == grid.width, "2D grid dimensions");
+    point_t seed = grid.point(7,5);
+    point_n<2> seed2 = grid2.point(coords_n<2>{{7,5}});
+
+    const stencil_n<2> axes2 = axis_stencil<2>();
+    const stencil_n<2> cube2 = cube_stencil<2>();
+    auto four2  = [&](const point_n<2> & p) {return neighbors_grid_n(p, grid2, axes2);};
+    auto eight2 = [&](const point_n<2> & p) {return neighbors_grid_n(p, grid2, cube2);};
+
+    std::streambuf* out = std::cout.rdbuf(nullptr);
+    auto four  = [&grid](const point_t& p) {return neighbors_grid<quad_stencil>(p,grid);};
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+    costs_t d4 = algo_run(grid, seed, grid.size(), four, transit_on_edge);
+    costs_t d8 = algo_run(grid, seed, grid.size(), eight, transit_on_edge);
+    costs_t f4 = algo_run(grid, seed, grid.size(), four, transit_in_simplex_exact);
+    costs_t f8 = algo_run(grid, seed, grid.size(), eight, transit_in_simplex_exact);
+    std::cout.rdbuf(out);
+    std::cout.clear();
+
+    ok &= expect(max_diff(algo_run_n(grid2, seed2, grid2.size(), four2, transit_on_edge_n<2>), d4) == 0, "2D axis stencil on edges is the 4-neighbors Dijkstra");
+    ok &= expect(max_diff(algo_run_n(grid2, seed2, grid2.size(), eight2, transit_on_edge_n<2>), d8) == 0, "2D cube stencil on edges is the 8-neighbors Dijkstra");
+    ok &= expect(max_diff(algo_run_n(grid2, seed2, grid2.size(), four2, transit_in_simplex_n<2>), f4) < 1e-9, "2D axis stencil in simplexes is the 4-neighbors exact fast marching");
+    ok &= expect(max_diff(algo_run_n(grid2, seed2, grid2.size(), eight2, transit_in_simplex_n<2>), f8) < 1e-9, "2D cube stencil in simplexes is the 8-neighbors exact fast marching");
+
+    // 3D.
+    const stencil_n<3> axes = axis_stencil<3>();
+    const stencil_n<3> edges = edge_stencil();
+    const stencil_n<3> cube = cube_stencil<3>();
+    // Vertices, edges and triangles of the 8 octahedron's triangles.
+    ok &= expect(axes.size() == 6 and axes.faces().size() == 6 + 12 + 8, "3D axis stencil");
+    // The 32 triangles of the cube with cut corners share 48 edges.
+    ok &= expect(edges.size() == 18 and edges.faces().size() == 18 + 48 + 32, "3D edge stencil");
+    // The 48 tetrahedra of the cube share 72 edges.
+    ok &= expect(cube.size() == 26 and cube.faces().size() == 26 + 72 + 48, "3D cube stencil");
+
+    grid_n<3> volume({{0,0,0}}, {{20,20,20}}, 1);
+    point_n<3> center = volume.point(coords_n<3>{{10,10,10}});
+    bool axial = true;
+    std::vector<double> edge_errors, simplex_errors;
+    for( const stencil_n<3> * stencil : {&axes, &edges, &cube} ) {
+        auto around = [&](const point_n<3> & p) {return neighbors_grid_n(p, volume, *stencil);};
+        costs_n<3> on_edge = algo_run_n(volume, center, volume.size(), around, transit_on_edge_n<3>);
+        costs_n<3> in_simplex = algo_run_n(volume, center, volume.size(), around, transit_in_simplex_n<3>);
+        for( long k = 0; k <= 10; ++k ) {
+            for( const costs_n<3> * costs : {&on_edge, &in_simplex} ) {
+                axial &= std::abs(costs->at(volume.point(coords_n<3>{{10+k,10,10}})) - k) < 1e-9;
+                axial &= std::abs(costs->at(volume.point(coords_n<3>{{10,10,10-k}})) - k) < 1e-9;
+            }
+        }
+        edge_errors.push_back(max_error(on_edge, center));
+        simplex_errors.push_back(max_error(in_simplex, center));
+        std::cout << "     " << stencil->size() << " neighbors: max error " << edge_errors.back()
+                  << " on edges, " << simplex_errors.back() << " in simplexes" << std::endl;
+    }
+    ok &= expect(axial, "3D costs along the axes are exact");
+    bool closer = true;
+    for( size_t s = 0; s < edge_errors.size(); ++s ) {
+        closer &= simplex_errors[s] < edge_errors[s];
+    }
+    ok &= expect(closer, "3D tetrahedral updates are closer to the euclidean distance than the edges");
+    ok &= expect(simplex_errors[2] < simplex_errors[0], "3D 26 neighbors are closer than 6 neighbors");
+
+    auto six = [&](const point_n<3> & p) {return neighbors_grid_n(p, volume, axes);};
+    auto twenty_six = [&](const point_n<3> & p) {return neighbors_grid_n(p, volume, cube);};
+    algo<neighbors::axis_grid_n<3, 1, 0, 20>, transit::on_edge> dijkstra6;
+    algo<neighbors::cube_grid_n<3, 1, 0, 20>, transit::in_simplex_exact> exact26;
+    bool same = true;
+    for( point_n<3> seed3 : {center, volume.point(coords_n<3>{{0,0,0}}), volume.point(coords_n<3>{{3,17,8}})} ) {
+        costs_n<3> d6 = dijkstra6(seed3, volume.size() / 2);
+        costs_n<3> x26 = exact26(seed3, volume.size() / 2);
+        same &= d6.size() == volume.size() and x26.size() == volume.size();
+        same &= std::equal(d6.data(), d6.data() + d6.size(), algo_run_n(volume, seed3, volume.size() / 2, six, transit_on_edge_n<3>).data());
+        same &= std::equal(x26.data(), x26.data() + x26.size(), algo_run_n(volume, seed3, volume.size() / 2, twenty_six, transit_in_simplex_n<3>).data());
+    }
+    ok &= expect(same, "3D policies give the same costs than algo_run_n");
+
+    return ok ? 0 : 1;
+}
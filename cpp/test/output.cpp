@@ -0,0 +1,98 @@
+/** Check the binary output of the costs.
+
+    - The npy header should be well-formed, and the data 64-bytes aligned.
+    - The values read back should be the costs, converted to the written type.
+    - Writing by chunks of rows, and copying into a buffer, should give the same bytes.
+    - The costs in single precision, and the ones of a workspace, should be written alike.
+  */
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cstring>
+
+#include "code.h"
+#include "output.h"
+#include "workspace.h"
+#include "expect.h"
+
+template<typename T>
+bool check_values(const costs_t & costs, const std::string & bytes, size_t offset)
+{
+    if( bytes.size() != offset + costs.size() * sizeof(T) ) {
+        return false;
+    }
+    for( size_t i = 0; i < costs.size(); ++i ) {
+        T v;
+        std::memcpy(&v, bytes.data() + offset + i * sizeof(T), sizeof(T));
+        if( v != static_cast<T>(costs.at(i)) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    grid_t grid(make_point(-5,-5), make_point(15,10), 1);
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+    std::streambuf* out = std::cout.rdbuf(nullptr);
+    // Not all the points are reached.
+    costs_t costs = algo_run(grid, make_point(0,0), 200, eight, transit_in_simplex_exact);
+    std::cout.rdbuf(out);
+    std::cout.clear();
+    bool ok = true;
+
+    std::ostringstream npy;
+    costs_write<float>(costs, npy, costs_format_t::npy);
+    std::string bytes = npy.str();
+    ok &= expect(bytes.compare(0, 8, std::string("\x93NUMPY\x01\x00", 8)) == 0, "npy magic and version");
+    size_t len = static_cast<unsigned char>(bytes[8]) + 256 * static_cast<unsigned char>(bytes[9]);
+    ok &= expect((10 + len) % 64 == 0 and bytes[9 + len] == '\n', "npy header is padded to 64 bytes");
+    std::string dict = bytes.substr(10, len);
+    ok &= expect(dict.find("'descr': '<f4'") != std::string::npos
+            and dict.find("'shape': (16, 21)") != std::string::npos, "npy descr and shape");
+    ok &= expect(check_values<float>(costs, bytes, 10 + len), "npy float32 values");
+
+    std::ostringstream raw;
+    costs_write<double>(costs, raw, costs_format_t::raw);
+    std::string rbytes = raw.str();
+    costs_header_t header;
+    std::memcpy(&header, rbytes.data(), sizeof(header));
+    ok &= expect(std::string(header.magic, 8) == "ALGOCF64" and header.width == 21 and header.height == 16, "raw header");
+    ok &= expect(check_values<double>(costs, rbytes, sizeof(header)), "raw float64 values");
+
+    std::ostringstream chunked;
+    costs_write<float>(costs, chunked, costs_format_t::npy, /*chunk_rows=*/3);
+    ok &= expect(chunked.str() == bytes, "chunks of rows give the same bytes");
+
+    std::vector<double> buffer(costs_bytes<float>(grid, costs_format_t::npy) / sizeof(double) + 1);
+    char* begin = reinterpret_cast<char*>(buffer.data());
+    char* end = costs_copy<float>(costs, begin, costs_format_t::npy);
+    ok &= expect(std::string(begin, end) == bytes, "copy into a buffer gives the same bytes");
+
+    out = std::cout.rdbuf(nullptr);
+    costs_of<float> single = algo_run<front_t,float>(grid, make_point(0,0), 200, eight, transit_in_simplex_exact_of<float>);
+    std::cout.rdbuf(out);
+    std::cout.clear();
+    std::ostringstream single_npy;
+    costs_write<float>(single, single_npy, costs_format_t::npy);
+    std::string sbytes = single_npy.str();
+    bool same_single = sbytes.size() == bytes.size() and sbytes.compare(0, 10 + len, bytes, 0, 10 + len) == 0;
+    for( size_t i = 0; i < single.size() and same_single; ++i ) {
+        float v;
+        std::memcpy(&v, sbytes.data() + 10 + len + i * sizeof(float), sizeof(float));
+        same_single &= v == single.at(i);
+    }
+    ok &= expect(same_single, "single precision costs are written as they are");
+
+    workspace_t<> workspace;
+    std::ostringstream touched;
+    costs_write<float>(algo_run(workspace, grid, make_point(0,0), 200, eight, transit_in_simplex_exact_of<double,touched_costs>), touched, costs_format_t::npy);
+    ok &= expect(touched.str() == bytes, "the costs of a workspace give the same bytes");
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+/** Check the extraction of the shortest paths from computed costs.
+
+    - Paths along the parents of a Dijkstra end on the seed, and their length is the cost of their target.
+    - Paths along the gradient of an exact fast marching end on the seed,
+      and are close to the straight line.
+    - Around a wall, both kind of paths never cross an obstacle.
+    - Extracting in parallel gives the same paths than extracting one by one.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#include "code.h"
+#include "speed.h"
+#include "paths.h"
+#include "expect.h"
+
+int main()
+{
+    grid_t grid(make_point(0,0), make_point(40,30), 1);
+    point_t seed = grid.point(5,5);
+    bool ok = true;
+
+    // A wall across x=20, with a single gap at the top, passable only for the walled fields.
+    std::vector<float> speeds(grid.size(), 1);
+    for( size_t j = 0; j < grid.height-3; ++j ) {
+        speeds[grid.index(20,j)] = 0;
+    }
+    speed_field_t walled(grid, speeds);
+
+    std::streambuf* out = std::cout.rdbuf(nullptr);
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+    auto around = [&grid,&walled](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid,walled);};
+    costs_t graph = algo_run(grid, seed, grid.size(), eight, transit_on_edge);
+    costs_t exact = algo_run(grid, seed, grid.size(), eight, transit_in_simplex_exact);
+    auto on_edge_speed = [&walled](const point_t& p, const neighbors_t& n, const costs_t& c) {return transit_on_edge_speed(p,n,c,walled);};
+    auto exact_speed = [&walled](const point_t& p, const neighbors_t& n, const costs_t& c) {return transit_in_simplex_exact_speed(p,n,c,walled);};
+    costs_t graph_walled = algo_run(grid, seed, grid.size(), around, on_edge_speed);
+    costs_t exact_walled = algo_run(grid, seed, grid.size(), around, exact_speed);
+    std::cout.rdbuf(out);
+    std::cout.clear();
+
+    std::vector<point_t> targets;
+    for( long i = 0; i < static_cast<long>(grid.width); i += 3 ) {
+        for( long j = 0; j < static_cast<long>(grid.height); j += 3 ) {
+            targets.push_back(grid.point(i,j));
+        }
+    }
+    work_stealing_pool pool(2);
+
+    std::vector<path_t> edges = paths_on_edge(graph, targets, pool);
+    bool seeded = true;
+    double length_diff = 0;
+    for( size_t t = 0; t < targets.size(); ++t ) {
+        seeded &= edges[t].front() == targets[t] and edges[t].back() == seed;
+        length_diff = std::max(length_diff, std::abs(path_length(edges[t]) - graph.at(targets[t])));
+    }
+    ok &= expect(seeded, "parents paths go from the target to the seed");
+    ok &= expect(length_diff < 1e-9, "parents paths length is the cost of their target");
+
+    std::vector<path_t> simplexes = paths_in_simplex(exact, targets, pool);
+    seeded = true;
+    double excess = 0;
+    for( size_t t = 0; t < targets.size(); ++t ) {
+        seeded &= simplexes[t].front() == targets[t] and simplexes[t].back() == seed;
+        excess = std::max(excess, path_length(simplexes[t]) - distance(targets[t], seed));
+    }
+    ok &= expect(seeded, "gradient paths go from the target to the seed");
+    std::cout << "     gradient paths are at most " << excess << " longer than the straight line" << std::endl;
+    ok &= expect(excess < 1, "gradient paths are nearly straight");
+
+    auto crosses = [&] (const std::vector<path_t> & paths, const costs_t & costs) {
+        for( auto & path : paths ) {
+            for( auto & p : path ) {
+                if( not walled.passable(grid.index(p)) or costs.at(p) == std::numeric_limits<double>::infinity() ) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+    std::vector<point_t> behind{ grid.point(30,5), grid.point(25,0), grid.point(40,10) };
+    std::vector<path_t> edges_walled = paths_on_edge(graph_walled, behind, pool);
+    std::vector<path_t> simplexes_walled = paths_in_simplex(exact_walled, behind, pool);
+    ok &= expect(not crosses(edges_walled, graph_walled), "parents paths go around the wall");
+    ok &= expect(not crosses(simplexes_walled, exact_walled), "gradient paths go around the wall");
+    bool detour = true;
+    for( size_t t = 0; t < behind.size(); ++t ) {
+        detour &= simplexes_walled[t].back() == seed and path_length(simplexes_walled[t]) > distance(behind[t], seed) + 10;
+    }
+    ok &= expect(detour, "gradient paths reach the seed through the gap");
+
+    bool same = true;
+    for( size_t t = 0; t < targets.size(); ++t ) {
+        same &= path_gradient(exact, targets[t]) == simplexes[t];
+    }
+    ok &= expect(same, "parallel extraction gives the same paths");
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+/** Check the work-stealing pool.
+
+    - Tasks submitted concurrently from several threads should all run, once.
+    - An exception thrown by a task should be rethrown by wait(), without blocking it,
+      and the pool should still run the tasks submitted afterwards.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include "pool.h"
+#include "expect.h"
+
+int main()
+{
+    bool ok = true;
+    work_stealing_pool pool(4);
+
+    std::atomic<size_t> done(0);
+    std::vector<std::thread> submitters;
+    for( unsigned int s = 0; s < 4; ++s ) {
+        submitters.push_back(std::thread([&pool,&done]() {
+            for( unsigned int t = 0; t < 1000; ++t ) {
+                pool.submit([&done](unsigned int) {done++;});
+            }
+        }));
+    }
+    for( std::thread & t : submitters ) {
+        t.join();
+    }
+    pool.wait();
+    ok &= expect(done == 4000, "concurrent submissions all run");
+
+    done = 0;
+    for( unsigned int t = 0; t < 100; ++t ) {
+        pool.submit([&done,t](unsigned int) {
+            if( t % 10 == 3 ) {
+                throw std::runtime_error("task " + std::to_string(t));
+            }
+            done++;
+        });
+    }
+    bool thrown = false;
+    try {
+        pool.wait();
+    } catch( const std::runtime_error & ) {
+        thrown = true;
+    }
+    ok &= expect(thrown and done == 90, "exceptions are rethrown by wait, once the other tasks are done");
+
+    pool.submit([&done](unsigned int) {done++;});
+    pool.wait();
+    ok &= expect(done == 91, "the pool runs tasks after an exception");
+
+    return ok ? 0 : 1;
+}
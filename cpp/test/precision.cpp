@@ -0,0 +1,92 @@
+/** Check the propagation in single precision.
+
+    - In double precision, the generic transits should give the same costs than the plain ones.
+    - In single precision, the costs should take half the memory,
+      reach the same points and deviate from the double precision ones by a few float epsilons.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+#include "code.h"
+#include "expect.h"
+
+//! Bytes allocated on the heap so far.
+static size_t allocated = 0;
+
+void* operator new(size_t size)
+{
+    allocated += size;
+    if( void* ptr = std::malloc(size) ) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+//! Bytes allocated by the costs of the given grid.
+template<typename Real>
+size_t allocated_by(const grid_t & grid)
+{
+    const size_t before = allocated;
+    costs_of<Real> costs(grid);
+    return allocated - before;
+}
+
+int main()
+{
+    bool ok = true;
+    grid_t grid(make_point(-20,-20), make_point(60,40), 0.5);
+    point_t seed = grid.point(30,50);
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+
+    std::streambuf* out = std::cout.rdbuf(nullptr);
+    costs_t graph = algo_run(grid, seed, grid.size(), eight, transit_on_edge);
+    costs_t mesh  = algo_run(grid, seed, grid.size(), eight,
+                        [](const point_t & p, const neighbors_t & n, const costs_t & c) {return transit_in_simplex(p,n,c,1/10.0);});
+    costs_t exact = algo_run(grid, seed, grid.size(), eight, transit_in_simplex_exact);
+
+    costs_t graph_d = algo_run<front_t,double>(grid, seed, grid.size(), eight, transit_on_edge_of<double>);
+    costs_t exact_d = algo_run<front_t,double>(grid, seed, grid.size(), eight, transit_in_simplex_exact_of<double>);
+
+    costs_of<float> graph_f = algo_run<front_t,float>(grid, seed, grid.size(), eight, transit_on_edge_of<float>);
+    costs_of<float> mesh_f  = algo_run<front_t,float>(grid, seed, grid.size(), eight,
+                        [](const point_t & p, const neighbors_t & n, const costs_of<float> & c) {return transit_in_simplex_of(p,n,c,1/10.0);});
+    costs_of<float> exact_f = algo_run<front_t,float>(grid, seed, grid.size(), eight, transit_in_simplex_exact_of<float>);
+    std::cout.rdbuf(out);
+    std::cout.clear();
+
+    ok &= expect(costs_deviation(graph_d, graph).max_abs == 0 and costs_deviation(exact_d, exact).max_abs == 0,
+                 "generic transits in double precision are the plain ones");
+    const size_t single_bytes = allocated_by<float>(grid);
+    const size_t double_bytes = allocated_by<double>(grid);
+    std::cout << "     costs of " << grid.size() << " points: " << single_bytes << " bytes in single precision, "
+              << double_bytes << " in double precision" << std::endl;
+    ok &= expect(single_bytes > 0 and 2 * single_bytes <= double_bytes and exact_f.size() == exact.size(),
+                 "single precision costs take half the memory");
+
+    // The costs go up to about 70, accumulated along about 140 steps:
+    // a few units in the last place of the largest costs.
+    const double tolerance = 100 * std::numeric_limits<float>::epsilon();
+    std::vector< std::pair<std::string, deviation_t> > deviations{
+        {"on edges", costs_deviation(graph_f, graph)},
+        {"in simplexes", costs_deviation(mesh_f, mesh)},
+        {"in simplexes, exact", costs_deviation(exact_f, exact)}
+    };
+    for( auto & d : deviations ) {
+        std::cout << "     " << d.first << ": max deviation " << d.second.max_abs << ", relative " << d.second.max_rel << std::endl;
+        ok &= expect(d.second.unmatched == 0, "single precision " + d.first + " reaches the same points");
+        ok &= expect(d.second.max_rel < tolerance, "single precision " + d.first + " is close to double precision");
+    }
+
+    return ok ? 0 : 1;
+}
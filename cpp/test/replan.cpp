@@ -0,0 +1,96 @@
+/** Check that incremental replanning gives the same costs than propagating again from scratch.
+
+    On a speed field, a wall is added, then a slow region, then both are removed.
+    After each change, the repaired costs are compared to the ones of a new propagation,
+    and the number of transits computed by the repair is compared to the one of the whole propagation.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#include "code.h"
+#include "speed.h"
+#include "replan.h"
+
+using neighbors_f = std::function< neighbors_t(const point_t&) >;
+using transit_f = std::function< double(const point_t &, const neighbors_t &, const costs_t &) >;
+
+double max_diff(const costs_t & a, const costs_t & b)
+{
+    double diff = 0;
+    for( size_t i = 0; i < a.size(); ++i ) {
+        if( std::isinf(a.at(i)) or std::isinf(b.at(i)) ) {
+            if( a.at(i) != b.at(i) ) {
+                return std::numeric_limits<double>::infinity();
+            }
+        } else {
+            diff = std::max(diff, std::abs(a.at(i) - b.at(i)));
+        }
+    }
+    return diff;
+}
+
+bool check(std::ostream & log, const std::string & name, const grid_t & grid, speed_field_t & field, neighbors_f neighbors, neighbors_f around, transit_f transit, double tolerance)
+{
+    bool ok = true;
+    point_t seed = grid.point(5, 5);
+    replanner_t<> replanner(grid, seed, neighbors, transit, 1e-9, around);
+
+    auto step = [&] (const std::string & change, const std::vector<point_t> & changed) {
+        size_t transits = replanner.update(changed);
+        size_t full = 0;
+        auto counted = [&](const point_t& p, const neighbors_t& n, const costs_t& c) {full++; return transit(p,n,c);};
+        costs_t scratch = algo_run(grid, seed, grid.size(), neighbors, counted);
+        double diff = max_diff(replanner.costs(), scratch);
+        log << name << ", " << change << ": max diff " << diff
+            << ", " << transits << " transits (vs. " << full << " from scratch)" << std::endl;
+        ok &= diff <= tolerance;
+    };
+
+    std::vector<point_t> wall;
+    for( long j = 0; j < 40; ++j ) {
+        wall.push_back(grid.point(30, j));
+        field.set_speed(grid.index(30, j), 0);
+    }
+    step("wall added", wall);
+
+    std::vector<point_t> mud;
+    for( long i = 40; i < 48; ++i ) {
+        for( long j = 50; j < 58; ++j ) {
+            mud.push_back(grid.point(i, j));
+            field.set_speed(grid.index(i, j), 0.25);
+        }
+    }
+    step("slow region added", mud);
+
+    for( const point_t & p : wall ) { field.set_speed(grid.index(p), 1); }
+    step("wall removed", wall);
+
+    for( const point_t & p : mud ) { field.set_speed(grid.index(p), 1); }
+    step("slow region removed", mud);
+
+    return ok;
+}
+
+int main()
+{
+    grid_t grid(make_point(0,0), make_point(63,63), 1);
+    speed_field_t field(grid, std::vector<float>(grid.size(), 1));
+    auto neighbors = [&grid,&field](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid,field);};
+    auto around = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+    auto graph = [&field](const point_t& p, const neighbors_t& n, const costs_t& c) {return transit_on_edge_speed(p,n,c,field);};
+    auto exact = [&field](const point_t& p, const neighbors_t& n, const costs_t& c) {return transit_in_simplex_exact_speed(p,n,c,field);};
+
+    // Silence the progress of the propagations.
+    std::ostream log(std::cout.rdbuf());
+    std::streambuf* out = std::cout.rdbuf(nullptr);
+    bool ok = true;
+    ok &= check(log, "Dijkstra", grid, field, neighbors, around, graph, 1e-9);
+    ok &= check(log, "Exact fast marching", grid, field, neighbors, around, exact, 1e-6);
+    std::cout.rdbuf(out);
+    std::cout.clear();
+    return ok ? 0 : 1;
+}
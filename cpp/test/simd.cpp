@@ -0,0 +1,81 @@
+/** Check the vectorized transits against the scalar ones, on whole propagations.
+
+    - For each set of kernels available on this CPU, with 4 and 8 neighbors,
+      propagating with the vectorized transits should give the same costs as the scalar ones.
+    - The vectorized transits selected as a policy should give the same costs as the scalar policy.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#define ALGOPATTERN_NO_MAIN
+#include "policies.cpp"
+#include "expect.h"
+
+//! Max difference between the costs of the same points, infinite if only one of them is reached.
+double max_diff(const costs_t & a, const costs_t & b)
+{
+    double diff = 0;
+    for( size_t idx = 0; idx < a.grid().size(); ++idx ) {
+        double ca = a.at(idx);
+        double cb = b.at(idx);
+        if( ca != cb ) {
+            diff = std::max(diff, std::isinf(ca) or std::isinf(cb) ? std::numeric_limits<double>::infinity() : std::abs(ca - cb));
+        }
+    }
+    return diff;
+}
+
+int main()
+{
+    bool ok = true;
+    grid_t grid(make_point(-3,-2), make_point(60,41), 0.5);
+    point_t seed = grid.point(17,30);
+    auto four  = [&grid](const point_t& p) {return neighbors_grid<quad_stencil>(p,grid);};
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+    std::vector< std::pair<std::string, std::function< neighbors_t(const point_t&) > > > neighborhoods{
+        {"4 neighbors", four}, {"8 neighbors", eight}
+    };
+
+    // Without the progress output.
+    auto run = [&grid,&seed] (std::function< neighbors_t(const point_t&) > neighbors,
+                              std::function< double(const point_t &, const neighbors_t &, const costs_t &) > transit) {
+        std::streambuf* out = std::cout.rdbuf(nullptr);
+        costs_t costs = algo_run(grid, seed, grid.size(), neighbors, transit);
+        std::cout.rdbuf(out);
+        std::cout.clear();
+        return costs;
+    };
+    for( const simd_kernels_t & kernels : simd_available() ) {
+        for( auto & n : neighborhoods ) {
+            std::string what = std::string(kernels.name) + ", " + n.first;
+            auto vgraph = [&kernels](const point_t & p, const neighbors_t & ns, const costs_t & c) {return transit_on_edge_simd(p,ns,c,kernels);};
+            ok &= expect(max_diff(run(n.second, vgraph),
+                                  run(n.second, transit_on_edge)) < 1e-9,
+                         what + ": same costs on edges");
+            for( double eps : {0.1, 0.01} ) {
+                auto vmesh = [&kernels,eps](const point_t & p, const neighbors_t & ns, const costs_t & c) {return transit_in_simplex_simd(p,ns,c,eps,kernels);};
+                auto mesh  = [eps](const point_t & p, const neighbors_t & ns, const costs_t & c) {return transit_in_simplex(p,ns,c,eps);};
+                ok &= expect(max_diff(run(n.second, vmesh),
+                                      run(n.second, mesh)) < 1e-9,
+                             what + ": same costs in simplexes, eps=" + std::to_string(eps));
+            }
+        }
+    }
+
+    using eight_policy = neighbors::octo_grid<1, -5, -5, 15, 15>;
+    point_t origin = make_point(0,0);
+    algo<eight_policy, transit::on_edge> graph;
+    algo<eight_policy, transit::on_edge_simd> vgraph;
+    ok &= expect(max_diff(vgraph(origin, 1000, nullptr, nullptr), graph(origin, 1000, nullptr, nullptr)) < 1e-9,
+                 std::string("policy ") + simd_kernels().name + ": same costs on edges");
+    algo<eight_policy, transit::in_simplex<std::ratio<1,100>>> mesh;
+    algo<eight_policy, transit::in_simplex_simd<std::ratio<1,100>>> vmesh;
+    ok &= expect(max_diff(vmesh(origin, 1000, nullptr, nullptr), mesh(origin, 1000, nullptr, nullptr)) < 1e-9,
+                 std::string("policy ") + simd_kernels().name + ": same costs in simplexes");
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+/** Check the propagation on heterogeneous speed fields.
+
+    - A uniform field of speed 2, memory-mapped from a raster file,
+      should halve the costs computed at unit speed.
+    - Obstacles should never be reached, and the front should go around them.
+    - Dead ends (a single passable neighbor) and scattered obstacles should be reached,
+      in simplexes as on edges.
+    - Invalid raster files should be rejected.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <random>
+
+#include "code.h"
+#include "speed.h"
+#include "expect.h"
+
+int main()
+{
+    grid_t grid(make_point(0,0), make_point(31,23), 1);
+    point_t seed = grid.point(3,3);
+    const std::string path = "test_speed.raster";
+    bool ok = true;
+
+    std::streambuf* out = std::cout.rdbuf(nullptr);
+    auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+    costs_t unit = algo_run(grid, seed, grid.size(), eight, transit_in_simplex_exact);
+
+    speed_raster_write(path, grid, std::vector<float>(grid.size(), 2));
+    speed_field_t fast(path);
+    auto fast_transit = [&fast](const point_t& p, const neighbors_t& n, const costs_t& c) {return transit_in_simplex_exact_speed(p,n,c,fast);};
+    costs_t halved = algo_run(grid, seed, grid.size(), eight, fast_transit);
+
+    // A wall across x=10, with a single gap at the top.
+    std::vector<float> speeds(grid.size(), 1);
+    for( size_t j = 0; j < grid.height-1; ++j ) {
+        speeds[grid.index(10,j)] = 0;
+    }
+    speed_field_t walled(grid, speeds);
+    auto around = [&grid,&walled](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid,walled);};
+    auto walled_transit = [&walled](const point_t& p, const neighbors_t& n, const costs_t& c) {return transit_on_edge_speed(p,n,c,walled);};
+    costs_t detour = algo_run(grid, seed, grid.size(), around, walled_transit);
+    costs_t direct = algo_run(grid, seed, grid.size(), eight, transit_on_edge);
+
+    // A dead end at the corner, with a single passable neighbor.
+    grid_t small(make_point(0,0), make_point(2,2), 1);
+    speed_field_t dead_end(small, {1,0,1, 1,1,1, 1,1,1});
+    auto small_four = [&small,&dead_end](const point_t& p) {return neighbors_grid<quad_stencil>(p,small,dead_end);};
+    auto dead_end_transit = [&dead_end](const point_t& p, const neighbors_t& n, const costs_t& c) {return transit_in_simplex_exact_speed(p,n,c,dead_end);};
+    costs_t cornered = algo_run(small, small.point(0,1), small.size(), small_four, dead_end_transit);
+
+    // Scattered obstacles, on 30% of the points.
+    std::mt19937 rng(0);
+    std::bernoulli_distribution obstacle(0.3);
+    std::vector<float> scattered(grid.size(), 1);
+    for( size_t i = 0; i < grid.size(); ++i ) {
+        scattered[i] = obstacle(rng) ? 0 : 1;
+    }
+    scattered[grid.index(3,3)] = 1;
+    speed_field_t random(grid, scattered);
+    auto random_around = [&grid,&random](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid,random);};
+    auto random_exact = [&random](const point_t& p, const neighbors_t& n, const costs_t& c) {return transit_in_simplex_exact_speed(p,n,c,random);};
+    auto random_graph = [&random](const point_t& p, const neighbors_t& n, const costs_t& c) {return transit_on_edge_speed(p,n,c,random);};
+    costs_t random_simplexes = algo_run(grid, seed, grid.size(), random_around, random_exact);
+    costs_t random_edges = algo_run(grid, seed, grid.size(), random_around, random_graph);
+    std::cout.rdbuf(out);
+    std::cout.clear();
+
+    ok &= expect(fast.width() == grid.width and fast.height() == grid.height, "mapped raster dimensions");
+    double max_diff = 0;
+    for( size_t i = 0; i < grid.size(); ++i ) {
+        max_diff = std::max(max_diff, std::abs(halved[i] - unit[i] / 2));
+    }
+    ok &= expect(max_diff < 1e-12, "uniform speed 2 halves the costs");
+
+    bool wall_unreached = true;
+    for( size_t j = 0; j < grid.height-1; ++j ) {
+        wall_unreached &= detour.at(grid.index(10,j)) == std::numeric_limits<double>::infinity();
+    }
+    ok &= expect(wall_unreached, "obstacles are not reached");
+    size_t behind = grid.index(12,3);
+    ok &= expect(detour[behind] < std::numeric_limits<double>::infinity(), "points behind the wall are reached");
+    ok &= expect(detour[behind] > direct[behind] + 30, "the front goes around the wall");
+
+    ok &= expect(std::abs(cornered[small.index(0,0)] - 1) < 1e-12, "a dead end is reached from its single neighbor");
+    ok &= expect(std::isinf(cornered[small.index(1,0)]), "the obstacle next to the dead end is not reached");
+    ok &= expect(small_four(small.point(1,0)).empty() and small_four(small.point(0,0)).size() == 2,
+                 "obstacles have no neighbors, and stay in the neighborhoods of the others");
+
+    bool obstacles_unreached = true;
+    bool reached_alike = true;
+    bool within_edges = true;
+    size_t reached = 0;
+    for( size_t i = 0; i < grid.size(); ++i ) {
+        if( scattered[i] == 0 ) {
+            obstacles_unreached &= std::isinf(random_simplexes[i]) and std::isinf(random_edges[i]);
+        } else {
+            // The transits in simplexes only join neighbors adjacent in the stencil,
+            // and thus reach the same points as the transits on edges, never at a higher cost.
+            reached_alike &= std::isinf(random_simplexes[i]) == std::isinf(random_edges[i]);
+            within_edges &= not (random_simplexes[i] > random_edges[i] + 1e-9);
+            reached += not std::isinf(random_simplexes[i]);
+        }
+    }
+    ok &= expect(obstacles_unreached, "scattered obstacles are not reached");
+    ok &= expect(reached_alike and reached > grid.size() / 4, "scattered obstacles: the same points are reached in simplexes and on edges");
+    ok &= expect(within_edges, "scattered obstacles: simplexes are not costlier than edges");
+
+    std::ofstream(path, std::ios::binary) << "NOTARASTER.......";
+    bool rejected = false;
+    try {
+        speed_field_t invalid(path);
+    } catch( const std::runtime_error & ) {
+        rejected = true;
+    }
+    ok &= expect(rejected, "invalid raster is rejected");
+    std::remove(path.c_str());
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+/** Check the propagation in a reused workspace.
+
+    - Successive runs, from other seeds and on other grids, should give the same costs than fresh ones.
+    - The arena should only grow for larger grids.
+    - The policies composition should give the same costs in a workspace.
+  */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+#define ALGOPATTERN_NO_MAIN
+#include "policies.cpp"
+#include "expect.h"
+
+//! Max difference between the costs of the same points.
+double max_diff(const touched_costs<> & a, const costs_t & b)
+{
+    const grid_t & grid = b.grid();
+    double diff = 0;
+    for( size_t idx = 0; idx < grid.size(); ++idx ) {
+        double ca = a.at(idx);
+        double cb = b.at(idx);
+        if( ca != cb ) {
+            diff = std::max(diff, std::isinf(ca) or std::isinf(cb) ? std::numeric_limits<double>::infinity() : std::abs(ca - cb));
+        }
+    }
+    return diff;
+}
+
+int main()
+{
+    bool ok = true;
+    std::vector<grid_t> grids{
+        grid_t(make_point(-5,-5), make_point(15,15), 1),
+        grid_t(make_point(0,0), make_point(40,12), 0.5),
+        grid_t(make_point(-5,-5), make_point(15,15), 1),
+        grid_t(make_point(0,0), make_point(5,7), 1)
+    };
+
+    workspace_t<> workspace;
+    bool same = true;
+    size_t capacity = 0;
+    bool grown = true;
+    for( const grid_t & grid : grids ) {
+        auto eight = [&grid](const point_t& p) {return neighbors_grid<octo_stencil>(p,grid);};
+        for( point_t seed : {grid.point(0,0), grid.point(grid.width/2, grid.height/3), grid.point(grid.width-1, grid.height-1)} ) {
+            // Some runs are stopped before the end.
+            for( unsigned int iterations : {static_cast<unsigned int>(grid.size()), static_cast<unsigned int>(grid.size() / 3)} ) {
+                std::streambuf* out = std::cout.rdbuf(nullptr);
+                costs_t graph = algo_run(grid, seed, iterations, eight, transit_on_edge);
+                costs_t exact = algo_run(grid, seed, iterations, eight, transit_in_simplex_exact);
+                std::cout.rdbuf(out);
+                std::cout.clear();
+                same &= max_diff(algo_run(workspace, grid, seed, iterations, eight, transit_on_edge_of<double,touched_costs>), graph) == 0;
+                same &= max_diff(algo_run(workspace, grid, seed, iterations, eight, transit_in_simplex_exact_of<double,touched_costs>), exact) == 0;
+            }
+        }
+        grown &= workspace.costs.capacity() == std::max(capacity, grid.size());
+        capacity = workspace.costs.capacity();
+    }
+    ok &= expect(same, "successive runs in a workspace give the same costs than fresh runs");
+    ok &= expect(grown, "the arena only grows for larger grids");
+
+    using eight = neighbors::octo_grid<1, -5, -5, 15, 15>;
+    algo<eight,transit::in_simplex_exact> exact8;
+    workspace_t<> policies;
+    same = true;
+    for( point_t seed : {make_point(0,0), make_point(10,-3), make_point(0,0)} ) {
+        std::streambuf* out = std::cout.rdbuf(nullptr);
+        costs_t fresh = exact8(seed, 300);
+        std::cout.rdbuf(out);
+        std::cout.clear();
+        same &= max_diff(exact8(policies, seed, 300), fresh) == 0;
+    }
+    ok &= expect(same, "policies: runs in a workspace give the same costs than fresh runs");
+
+    return ok ? 0 : 1;
+}
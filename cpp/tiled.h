@@ -0,0 +1,238 @@
+#pragma once
+
+#include <thread>
+#include <atomic>
+
+#include "code.h"
+
+/** \defgroup Tiled Domain decomposition of the propagation across several threads.
+
+    The grid is split in rectangular tiles, each one holding a copy of its costs,
+    surrounded by a ghost layer of the costs of the adjacent tiles.
+    Tiles are solved concurrently, each with its own front, running the usual
+    neighborhood and transit functions restricted to the tile.
+    Then, the new costs of the tiles are written back into the global grid,
+    from which the ghost layers are refreshed, until no cost decreases anymore.
+    Only the tiles adjacent to a tile which has changed are solved at the next round,
+    so that the work follows the expansion of the global front.
+
+  @{
+*/
+
+/** A rectangular block of the grid, along with its ghost layer. */
+class tile_t
+{
+    public:
+        /** Interior [i0,i1[ x [j0,j1[ of the given grid.
+
+            The local costs also cover the ghost layer, one point wide,
+            which is enough for neighborhoods reaching the adjacent points only. */
+        tile_t(const grid_t & grid, long i0_, long j0_, long i1_, long j1_)
+            : i0(i0_), j0(j0_), i1(i1_), j1(j1_),
+              gi0(std::max(i0_-1, 0L)), gj0(std::max(j0_-1, 0L)),
+              costs( grid_t(grid.point(gi0, gj0),
+                            grid.point(std::min(i1_, static_cast<long>(grid.width )-1),
+                                       std::min(j1_, static_cast<long>(grid.height)-1)),
+                            grid.step) ),
+              solved(false)
+        {}
+
+        bool interior(long i, long j) const {return i0 <= i and i < i1 and j0 <= j and j < j1;}
+
+        //! Interior, in global grid coordinates.
+        const long i0, j0, i1, j1;
+        //! Origin of the ghost layer, in global grid coordinates.
+        const long gi0, gj0;
+        //! Costs of the interior and of the ghost layer.
+        costs_t costs;
+        //! True once the tile has been solved at least once.
+        bool solved;
+};
+
+/** Solve the given tile from the current global costs.
+
+  Costs of the interior which may change are the ones adjacent to the ghost layer
+  (or any point already having a cost, the first time the tile is solved, e.g. the seed).
+  They are updated from the ghost layer, then a local front propagates the decreased costs
+  in the interior, re-relaxing points until they are accepted.
+
+  Reads the global costs, but only writes the costs of the tile.
+  \return True if a cost of the interior has decreased.
+ */
+template<typename Front, typename N, typename T>
+bool tile_solve(tile_t & tile, const costs_t & global, N & neighbors, T & transit)
+{
+    const grid_t & grid = global.grid();
+    costs_t & costs = tile.costs;
+    const grid_t & local = costs.grid();
+
+    // Refresh the ghost layer (and the interior, which is left untouched by other tiles).
+    for( size_t j = 0; j < local.height; ++j ) {
+        for( size_t i = 0; i < local.width; ++i ) {
+            costs[local.index(i,j)] = global.at( grid.index(tile.gi0 + i, tile.gj0 + j) );
+        }
+    }
+
+    Front front(local);
+    std::vector<bool> accepted(local.size(), false);
+
+    for( long j = tile.j0; j < tile.j1; ++j ) {
+        for( long i = tile.i0; i < tile.i1; ++i ) {
+            bool border = i == tile.i0 or i == tile.i1-1 or j == tile.j0 or j == tile.j1-1;
+            point_t p = grid.point(i,j);
+            size_t ip = local.index(p);
+            if( not tile.solved and has_cost(p, costs) ) {
+                front.update(ip, costs[ip]);
+
+            } else if( border ) {
+                neighbors_t around = neighbors(p);
+                if( std::any_of(begin(around), end(around), [&costs](const point_t& n){return has_cost(n,costs);}) ) {
+                    double c = transit(p, around, costs);
+                    if( c < costs[ip] ) {
+                        costs[ip] = c;
+                        front.update(ip, c);
+                    }
+                }
+            }
+        }
+    }
+    tile.solved = true;
+
+    bool changed = not front.empty();
+    while( not front.empty() ) {
+        size_t ia = front.pop();
+        accepted[ia] = true;
+        for( auto n : neighbors(local.point(ia)) ) {
+            size_t in = local.index(n);
+            if( tile.interior(grid.i(n), grid.j(n)) and not accepted[in] ) {
+                double c = transit(n, neighbors(n), costs);
+                if( c < costs[in] ) {
+                    costs[in] = c;
+                    front.update(in, c);
+                }
+            }
+        }
+    }
+    return changed;
+}
+
+/** Propagate the costs from the given seed, over tiles solved in parallel.
+
+  The given neighborhood and transit are called concurrently and should thus be thread-safe.
+
+  \param grid The grid on which the costs are computed.
+  \param seed The point with NULL cost.
+  \param tile_size The width (and height) of the tiles, in number of points.
+  \param threads The number of threads solving the tiles.
+  \param rounds The maximum number of exchanges between tiles.
+  \return The costs grid: <points index> => <cost>
+ */
+template<typename Front = front_t>
+costs_t tiled_run(
+        const grid_t & grid,
+        point_t seed,
+        size_t tile_size,
+        unsigned int threads,
+        unsigned int rounds,
+        std::function< neighbors_t(const point_t&) > neighbors,
+        std::function< double(const point_t &, const neighbors_t &, const costs_t &) > transit
+    )
+{
+    assert(tile_size > 0);
+    assert(threads > 0);
+    costs_t costs(grid);
+    costs[seed] = 0;
+
+    // Split the grid.
+    const long tw = static_cast<long>( (grid.width  + tile_size - 1) / tile_size );
+    const long th = static_cast<long>( (grid.height + tile_size - 1) / tile_size );
+    const long ts = static_cast<long>(tile_size);
+    std::vector<tile_t> tiles;
+    for( long tj = 0; tj < th; ++tj ) {
+        for( long ti = 0; ti < tw; ++ti ) {
+            tiles.push_back( tile_t(grid, ti*ts, tj*ts,
+                        std::min((ti+1)*ts, static_cast<long>(grid.width )),
+                        std::min((tj+1)*ts, static_cast<long>(grid.height))) );
+        }
+    }
+
+    // Start from the tile holding the seed.
+    std::vector<size_t> active{ static_cast<size_t>( (grid.j(seed) / ts) * tw + grid.i(seed) / ts ) };
+    std::vector<char> changed(tiles.size());
+
+    for( unsigned int r = 0; r < rounds and not active.empty(); ++r ) {
+        std::fill(begin(changed), end(changed), false);
+
+        // Solve the active tiles concurrently, reading the global costs only.
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            for( size_t k = next++; k < active.size(); k = next++ ) {
+                changed[active[k]] = tile_solve<Front>(tiles[active[k]], costs, neighbors, transit);
+            }
+        };
+        std::vector<std::thread> pool;
+        for( unsigned int t = 1; t < threads; ++t ) {
+            pool.push_back( std::thread(worker) );
+        }
+        worker();
+        for( std::thread & t : pool ) {
+            t.join();
+        }
+
+        // Write back the interiors and activate the tiles around the changed ones.
+        std::vector<char> next_active(tiles.size(), false);
+        for( long tj = 0; tj < th; ++tj ) {
+            for( long ti = 0; ti < tw; ++ti ) {
+                const tile_t & tile = tiles[tj*tw + ti];
+                if( not changed[tj*tw + ti] ) {
+                    continue;
+                }
+                const grid_t & local = tile.costs.grid();
+                for( long j = tile.j0; j < tile.j1; ++j ) {
+                    for( long i = tile.i0; i < tile.i1; ++i ) {
+                        costs[grid.index(i,j)] = tile.costs.at( local.index(i - tile.gi0, j - tile.gj0) );
+                    }
+                }
+                for( long dj = -1; dj <= 1; ++dj ) {
+                    for( long di = -1; di <= 1; ++di ) {
+                        if( (di != 0 or dj != 0) and 0 <= ti+di and ti+di < tw and 0 <= tj+dj and tj+dj < th ) {
+                            next_active[(tj+dj)*tw + ti+di] = true;
+                        }
+                    }
+                }
+            }
+        }
+        active.clear();
+        for( size_t k = 0; k < tiles.size(); ++k ) {
+            if( next_active[k] ) {
+                active.push_back(k);
+            }
+        }
+    }
+    return costs;
+}
+
+/** A tiled algorithm is a combination of a neighborhood and an Hopf-Lax operator, solved over parallel tiles.
+
+    Takes the same operators as the CRTP or strategy algo classes,
+    with an interface which allows to use it in their place.
+    The iterations are then the maximum number of exchanges between tiles. */
+template<typename N, typename T, typename Front = front_t>
+class tiled_algo
+{
+    protected:
+        N & neighbors;
+        T & transit;
+        size_t tile_size;
+        unsigned int threads;
+    public:
+        tiled_algo(N & neighbors_, T & hl, size_t tile_size_ = 64, unsigned int threads_ = std::max(1U, std::thread::hardware_concurrency()))
+            : neighbors(neighbors_), transit(hl), tile_size(tile_size_), threads(threads_) {}
+
+        costs_t operator()(point_t seed, unsigned int iterations)
+        {
+            return tiled_run<Front>(this->neighbors.grid, seed, tile_size, threads, iterations, std::ref(this->neighbors), std::ref(this->transit));
+        }
+};
+
+/** @} Tiled */
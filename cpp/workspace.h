@@ -0,0 +1,174 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "code.h"
+
+/** \defgroup Workspace Buffers reused across runs, reset in the time of the previous run.
+
+    Instead of allocating (and freeing) the costs and the front for each run,
+    a workspace allocates them on first use, and only grows them for larger grids.
+    The costs remember the points set by the run, and only forget these ones
+    when the next run starts, instead of clearing the whole grid.
+    The front only holds the nodes left by the previous run (if any), and is cleared in a time proportional to their number.
+
+    Neighborhoods are held inline (see neighbors_t), and need no buffer.
+
+  @{
+*/
+
+/** Costs in an arena sized on first use, which remembers the points set by the run.
+
+    All the points of the arena have an infinite cost, but the ones set by the run,
+    which are forgotten (made infinite again) when the next run starts.
+    Reading a cost is thus a plain access, as for a costs_of,
+    and only setting the first cost of a point records it.
+    Can be given to the transit functions suffixed by _of, and to algo_propagate, instead of a costs_of.
+  */
+template<typename Real = double>
+class touched_costs
+{
+    public:
+        touched_costs() : _grid(make_point(0,0), make_point(0,0), 1), _capacity(0), _costs(nullptr) {}
+
+        touched_costs(const touched_costs &) = delete;
+        touched_costs & operator=(const touched_costs &) = delete;
+
+        /** Forget all the costs, and use the given grid.
+
+            In a time proportional to the number of points set by the previous run,
+            unless the grid has more points than all the previous ones. */
+        void reset(const grid_t & grid_)
+        {
+            _grid = grid_;
+            if( _grid.size() > _capacity ) {
+                _capacity = _grid.size();
+                _costs.reset(new Real[_capacity]);
+                std::fill(_costs.get(), _costs.get() + _capacity, std::numeric_limits<Real>::infinity());
+                // A point is recorded at most once per run, unless its cost is set to infinity.
+                _touched.clear();
+                _touched.reserve(_capacity);
+            } else if( _touched.size() < _capacity ) {
+                for( size_t idx : _touched ) {
+                    _costs[idx] = std::numeric_limits<Real>::infinity();
+                }
+                _touched.clear();
+            } else {
+                // Too many points have been recorded, some may have been missed.
+                std::fill(_costs.get(), _costs.get() + _capacity, std::numeric_limits<Real>::infinity());
+                _touched.clear();
+            }
+        }
+
+        const grid_t & grid() const {return _grid;}
+        size_t size() const {return _grid.size();}
+        //! Number of points the arena can hold.
+        size_t capacity() const {return _capacity;}
+
+        Real at(size_t idx) const
+        {
+            assert(idx < size());
+            return _costs[idx];
+        }
+
+        Real& operator[](size_t idx)
+        {
+            assert(idx < size());
+            if( std::isinf(_costs[idx]) and _touched.size() < _capacity ) {
+                _touched.push_back(idx);
+            }
+            return _costs[idx];
+        }
+
+        Real  at        (const point_t & p) const {return at(_grid.index(p));}
+        Real& operator[](const point_t & p)       {return (*this)[_grid.index(p)];}
+
+        //! The contiguous costs, in the grid's index order.
+        const Real* data() const {return _costs.get();}
+
+    protected:
+        grid_t _grid;
+        size_t _capacity;
+        std::unique_ptr<Real[]> _costs;
+        //! The points which may have been set since the last reset.
+        std::vector<size_t> _touched;
+};
+
+//! Same as for a costs_of (see neighbors_indexed).
+template<typename Real>
+bool neighbors_indexed(const neighbors_t & neighbors, const touched_costs<Real> & costs) {return neighbors.indexed_on(costs.grid());}
+
+template<typename Real>
+void neighbors_costs(const neighbors_t & neighbors, const touched_costs<Real> & costs, Real * dest)
+{
+    const bool indexed = neighbors.indexed_on(costs.grid());
+    for( size_t k = 0; k < neighbors.size(); ++k ) {
+        dest[k] = indexed ? costs.at(neighbors.index(k)) : costs.at(neighbors[k]);
+    }
+}
+
+/** The costs and the front of a run, reused across runs (see touched_costs). */
+template<typename Front = front_t, typename Real = double>
+class workspace_t
+{
+    public:
+        workspace_t() : _nodes(0), _step(0) {}
+
+        /** Prepare a run on the given grid.
+
+            The front is only built again if the grid does not have the same number of points (or step) than the previous one. */
+        void reset(const grid_t & grid)
+        {
+            costs.reset(grid);
+            if( not _front or grid.size() != _nodes or grid.step != _step ) {
+                _front.reset(new Front(grid));
+                _nodes = grid.size();
+                _step = grid.step;
+            } else {
+                _front->clear();
+            }
+        }
+
+        Front & front() {assert(_front); return *_front;}
+
+        touched_costs<Real> costs;
+
+    protected:
+        std::unique_ptr<Front> _front;
+        size_t _nodes;
+        double _step;
+};
+
+/** Propagate the front from the given seed, in the given workspace, without printing progress.
+
+  \return The costs, valid until the next run in the workspace.
+*/
+template<typename Front, typename Real, typename N, typename T>
+const touched_costs<Real> & algo_run(workspace_t<Front,Real> & workspace, const grid_t & grid, point_t seed, unsigned int iterations, N & neighbors, T & transit)
+{
+    workspace.reset(grid);
+    workspace.costs[seed] = 0;
+    workspace.front().push(grid.index(seed), 0);
+    algo_propagate(workspace.costs, nullptr, workspace.front(), iterations, neighbors, transit, nullptr);
+    return workspace.costs;
+}
+
+/** Compute the cost from the seed to the goal only (see algo_goal), in the given workspace.
+
+  Once the workspace has been sized for the grid, the time of a query only grows with the number of points it reaches,
+  instead of with the area of the grid.
+  The transit is given on the costs of the workspace (e.g. transit_on_edge_of<double,touched_costs>).
+*/
+template<typename Front, typename N, typename T>
+goal_cost_t algo_goal(workspace_t<Front,double> & workspace, const grid_t & grid, point_t seed, point_t goal, unsigned int iterations, N & neighbors, T & transit, double heuristic_scale = 1)
+{
+    workspace.reset(grid);
+    workspace.costs[seed] = 0;
+    workspace.front().push(grid.index(seed), heuristic_scale * distance(seed, goal));
+    return algo_goal_propagate(workspace.costs, workspace.front(), goal, iterations, neighbors, transit, heuristic_scale);
+}
+
+/** @} Workspace */